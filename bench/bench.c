@@ -0,0 +1,887 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../deci.h"
+#include "../deci_regroup.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define HAVE_RDTSC 1
+#else
+#   define HAVE_RDTSC 0
+#endif
+
+#if BENCH_WITH_GMP
+#   include <math.h>
+#   include <gmp.h>
+#endif
+
+// Usage:
+//     bench [-l MAX_LINEAR] [-q MAX_QUADRATIC] [-t MIN_TIME_MS] [OP...]
+//
+// Times every exported operation over a sweep of operand sizes (1, 2, 5, 10, 20, 50, ... words),
+// up to MAX_LINEAR words for linear-time operations and up to MAX_QUADRATIC words for
+// quadratic-time ones, and writes the results to stdout as JSON. If any OP names are given, only
+// these operations are timed.
+//
+// Each measurement repeats the operation until at least MIN_TIME_MS milliseconds have passed.
+// Operations that destroy their input have it restored before each call; the time taken by the
+// restoring is measured separately and subtracted.
+
+enum {
+    LINEAR,
+    QUADRATIC,
+};
+
+typedef struct {
+    size_t n;
+
+    // Working spans and their pristine copies.
+    deci_UWORD *a, *a0;
+    size_t na;
+    deci_UWORD *b, *b0;
+    size_t nb;
+    // If set by 'init', 'a0' is made a multiple of 'b0'.
+    bool exact;
+    // If set by 'init', the packed format of 'a0' is written into 'd'.
+    bool packed;
+    // If set by 'init', the zero words of 'b0' are replaced with ones.
+    bool nonzero;
+
+    // Output and scratch buffers; both have capacity of at least (2 * n + 4) words.
+    deci_UWORD *out;
+    deci_UWORD *scratch;
+    deci_DOUBLE_UWORD *d;
+
+#if BENCH_WITH_GMP
+    mp_limb_t *ga, *gb, *gout, *gscratch;
+    mp_size_t gn;
+#endif
+} Bench;
+
+typedef struct {
+    const char *name;
+    int complexity;
+    bool destructive;
+    // Sets 'na' and 'nb' from 'n'; if NULL, (na = nb = n).
+    void (*init)(Bench *b);
+    void (*run)(Bench *b);
+#if BENCH_WITH_GMP
+    // If not NULL, runs the closest GMP counterpart on 'gn'-limb operands.
+    void (*run_gmp)(Bench *b);
+#endif
+} Op;
+
+static volatile deci_DOUBLE_UWORD sink;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static deci_UWORD random_word(void)
+{
+    return rng_next() % DECI_BASE;
+}
+
+// Fills (w ... w + n) with random words, the most significant one being non-zero.
+static void fill_random(deci_UWORD *w, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        w[i] = random_word();
+    if (n && !w[n - 1])
+        w[n - 1] = 1;
+}
+
+static void *x_calloc(size_t n, size_t size)
+{
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fputs("Out of memory.\n", stderr);
+        abort();
+    }
+    return p;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// --- operations -------------------------------------------------------------------------
+
+static void init_div(Bench *b)
+{
+    b->na = 2 * b->n;
+    b->nb = b->n;
+}
+
+static void init_div_big(Bench *b)
+{
+    b->na = 2 * b->n + 2;
+    b->nb = b->n + 2;
+}
+
+// A quotient of a few words, as in dividing a price by a quantity.
+static void init_div_short(Bench *b)
+{
+    b->na = b->n + 2;
+    b->nb = b->n;
+}
+
+// Divisors of two and three words, which 'deci_div()' hands to 'deci_divmod_dword()' and
+// 'deci_divmod_tword()'.
+static void init_div_dword(Bench *b)
+{
+    b->nb = 2;
+}
+
+static void init_div_tword(Bench *b)
+{
+    b->nb = 3;
+}
+
+static void init_divexact(Bench *b)
+{
+    init_div(b);
+    b->exact = true;
+}
+
+static void init_divexact_uword(Bench *b)
+{
+    b->nb = 1;
+    b->exact = true;
+}
+
+static void init_unpack(Bench *b)
+{
+    b->packed = true;
+}
+
+static void init_factors(Bench *b)
+{
+    b->nonzero = true;
+}
+
+static void init_gcd(Bench *b)
+{
+    b->na = b->n;
+    b->nb = b->n;
+}
+
+static void run_add(Bench *b)
+{
+    sink = deci_add(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+static void run_sub_raw(Bench *b)
+{
+    sink = deci_sub_raw(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+static void run_sub(Bench *b)
+{
+    sink = deci_sub(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+// The following take the operands in random order, so that the difference is negative about half
+// of the time, as in sign-magnitude arithmetic.
+
+static void run_sub_mixed(Bench *b)
+{
+    if (rng_next() & 1)
+        sink = deci_sub(b->a, b->a + b->na, b->b, b->b + b->nb);
+    else
+        sink = deci_sub(b->b, b->b + b->nb, b->a, b->a + b->na);
+}
+
+static void run_absdiff_mixed(Bench *b)
+{
+    if (rng_next() & 1)
+        sink = deci_absdiff(b->a, b->a + b->na, b->b, b->b + b->nb);
+    else
+        sink = deci_absdiff(b->b, b->b + b->nb, b->a, b->a + b->na);
+}
+
+static void run_absdiff_out_mixed(Bench *b)
+{
+    if (rng_next() & 1)
+        sink = deci_absdiff_out(b->a, b->a + b->na, b->b, b->b + b->nb, b->out);
+    else
+        sink = deci_absdiff_out(b->b, b->b + b->nb, b->a, b->a + b->na, b->out);
+}
+
+static void run_uncomplement(Bench *b)
+{
+    sink = deci_uncomplement(b->a, b->a + b->na);
+}
+
+static void run_add_scaled(Bench *b)
+{
+    b->out[b->nb] = 0;
+    b->out[b->nb + 1] = 0;
+    deci_add_scaled(b->out, 123456 % DECI_BASE, b->b, b->b + b->nb);
+}
+
+static void run_sub_scaled_raw(Bench *b)
+{
+    sink = deci_sub_scaled_raw(b->a, b->a + b->na, 123456 % DECI_BASE, b->b, b->b + b->nb);
+}
+
+static void run_mul_uword(Bench *b)
+{
+    sink = deci_mul_uword(b->a, b->a + b->na, 123456 % DECI_BASE);
+}
+
+static void run_divmod_uword(Bench *b)
+{
+    sink = deci_divmod_uword(b->a, b->a + b->na, 7654);
+}
+
+static void run_mod_uword(Bench *b)
+{
+    sink = deci_mod_uword(b->a, b->a + b->na, 7654);
+}
+
+// Sixteen moduli, a typical count for residue-number-system tricks.
+static const deci_UWORD MULTI_DIVISORS[] = {
+    7654, 7, 9973, 9999, 1234, 8191, 4096, 5000, 3, 6561, 9001, 7919, 2, 11, 101, 997,
+};
+
+enum { NMULTI_DIVISORS = sizeof(MULTI_DIVISORS) / sizeof(MULTI_DIVISORS[0]) };
+
+static void run_mod_uword_multi(Bench *b)
+{
+    deci_UWORD out[NMULTI_DIVISORS];
+    deci_mod_uword_multi(b->a, b->a + b->na, MULTI_DIVISORS, NMULTI_DIVISORS, out);
+    sink = out[NMULTI_DIVISORS - 1];
+}
+
+// What 'deci_mod_uword_multi()' replaces.
+static void run_mod_uword_x16(Bench *b)
+{
+    for (size_t i = 0; i < NMULTI_DIVISORS; ++i)
+        sink = deci_mod_uword(b->a, b->a + b->na, MULTI_DIVISORS[i]);
+}
+
+static void run_mul(Bench *b)
+{
+    deci_zero_out_n(b->out, b->na + b->nb);
+    deci_mul(b->a, b->a + b->na, b->b, b->b + b->nb, b->out);
+}
+
+static void run_prod_uwords(Bench *b)
+{
+    sink = deci_prod_uwords(b->b, b->nb, b->out, b->scratch);
+}
+
+// What 'deci_prod_uwords()' replaces: multiplying a growing span by the factors one at a time.
+static void run_prod_uwords_seq(Bench *b)
+{
+    size_t n = 1;
+    b->out[0] = 1;
+    for (size_t i = 0; i < b->nb; ++i) {
+        const deci_UWORD hi = deci_mul_uword(b->out, b->out + n, b->b[i]);
+        if (hi)
+            b->out[n++] = hi;
+    }
+    sink = n;
+}
+
+static void run_factorial(Bench *b)
+{
+    sink = deci_factorial(b->n, b->out, b->scratch);
+}
+
+static void run_binomial(Bench *b)
+{
+    sink = deci_binomial(b->n, b->n / 2, b->out, b->scratch);
+}
+
+// A one-word base raised to the 'n'-th power, so that the result is about 'n' words.
+static void run_pow(Bench *b)
+{
+    deci_UWORD base = DECI_BASE - 7;
+    sink = deci_pow(&base, &base + 1, b->n, b->out, b->scratch);
+}
+
+// 2 raised to the power that makes the result about 'n' words.
+static size_t pow2_exponent(size_t n)
+{
+    return n * DECI_BASE_LOG * 3321 / 1000;
+}
+
+static void run_pow2(Bench *b)
+{
+    sink = deci_pow2(pow2_exponent(b->n), b->out, b->scratch);
+}
+
+// What 'deci_pow2()' replaces: multiplying a growing span by powers of two, a pass at a time.
+static void run_pow2_seq(Bench *b)
+{
+    const size_t cap = deci_pow2_nwords_max(pow2_exponent(b->n));
+    deci_zero_out_n(b->out, cap);
+    b->out[0] = 1;
+    sink = deci_mul_pow2(b->out, b->out + cap, pow2_exponent(b->n));
+}
+
+static void run_divmod_unsafe(Bench *b)
+{
+    sink = deci_divmod_unsafe(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+static void run_mul_inplace(Bench *b)
+{
+    deci_mul_inplace(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+// The bottom half of the product, as in arithmetic modulo DECI_BASE^n.
+static void run_mullo(Bench *b)
+{
+    deci_mullo(b->a, b->b, b->na, b->out);
+}
+
+static void run_mullo_add(Bench *b)
+{
+    deci_mullo_add(b->a, b->b, b->b, b->na);
+}
+
+// The top half of the product, as in fixed-precision floating point.
+static void run_mulhi(Bench *b)
+{
+    deci_mulhi(b->a, b->a + b->na, b->b, b->b + b->nb, b->na, b->out);
+}
+
+static void run_mulhi_exact(Bench *b)
+{
+    deci_mulhi_exact(b->a, b->a + b->na, b->b, b->b + b->nb, b->na, b->out, b->scratch);
+}
+
+// Budget per step of the resumable operations.
+enum { STEP_BUDGET = 256 };
+
+static void run_mul_steps(Bench *b)
+{
+    deci_zero_out_n(b->out, b->na + b->nb);
+    deci_MulState st;
+    deci_mul_begin(&st, b->a, b->a + b->na, b->b, b->b + b->nb, b->out);
+    while (!deci_mul_step(&st, STEP_BUDGET)) {
+    }
+}
+
+static void run_divmod_steps(Bench *b)
+{
+    deci_DivmodState st;
+    deci_divmod_begin(&st, b->a, b->a + b->na, b->b, b->b + b->nb);
+    while (!deci_divmod_step(&st, STEP_BUDGET)) {
+    }
+    sink = st.qhi;
+}
+
+static void run_tobits_steps(Bench *b)
+{
+    deci_TobitsState st;
+    deci_tobits_begin(&st, b->a, b->a + b->na, b->out);
+    while (!deci_tobits_step(&st, STEP_BUDGET)) {
+    }
+    sink = st.nout;
+}
+
+static void run_div(Bench *b)
+{
+    sink = deci_div(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+static void run_mod(Bench *b)
+{
+    sink = deci_mod(b->a, b->a + b->na, b->b, b->b + b->nb);
+}
+
+static void run_divrem(Bench *b)
+{
+    size_t nr;
+    sink = deci_divrem(b->a, b->a + b->na, b->b, b->b + b->nb, b->out, b->scratch, &nr);
+}
+
+static void run_div_appr(Bench *b)
+{
+    sink = deci_div_appr(b->a, b->a + b->na, b->b, b->b + b->nb, b->out, b->scratch);
+}
+
+static void run_quotient(Bench *b)
+{
+    sink = deci_quotient(b->a, b->a + b->na, b->b, b->b + b->nb, b->out, b->scratch);
+}
+
+static void run_divexact_uword(Bench *b)
+{
+    deci_divexact_uword(b->a, b->a + b->na, b->b[0]);
+}
+
+static void run_divexact(Bench *b)
+{
+    sink = deci_divexact(b->a, b->a + b->na, b->b, b->b + b->nb, b->scratch);
+}
+
+static void run_pack(Bench *b)
+{
+    sink = deci_pack(b->a, b->a + b->na, (unsigned char *) b->out);
+}
+
+static void run_unpack(Bench *b)
+{
+    // Trailing bytes are ignored, so the whole buffer can be passed.
+    sink = deci_unpack((unsigned char *) b->d, deci_packed_size_max(b->na), b->out);
+}
+
+// Converts to the other configuration; 'out' has room for either.
+static void run_regroup(Bench *b)
+{
+#if DECI_WE_ARE_64_BIT
+    sink = deci_regroup_9to4(b->a, b->na, (uint16_t *) b->out);
+#else
+    sink = deci_regroup_4to9(b->a, b->na, (uint32_t *) b->out);
+#endif
+}
+
+static void run_tobits_round(Bench *b)
+{
+    sink = deci_tobits_round(b->a, b->a + b->na);
+}
+
+// Spans of more than 309 digits overflow, and only cost the check of their length.
+static void run_to_double(Bench *b)
+{
+    sink = deci_to_double(b->a, b->a + b->na) != 0;
+}
+
+static void run_tolong(Bench *b)
+{
+    deci_tolong(b->a, b->a + b->na, b->d);
+}
+
+static void run_long_tobits_round(Bench *b)
+{
+    deci_tolong(b->a, b->a + b->na, b->d);
+    sink = deci_long_tobits_round(b->d, b->d + (b->na / 2) + (b->na % 2));
+}
+
+static void run_frombits_round(Bench *b)
+{
+    sink = deci_frombits_round(b->a, b->a + b->na);
+}
+
+// The same scaling as 'deci_frombits_round()'; the top word is cleared to make room.
+static void run_mul_pow2(Bench *b)
+{
+    b->a[b->na - 1] = 0;
+    sink = deci_mul_pow2(b->a, b->a + b->na, DECI_WORD_BITS);
+}
+
+// The same scaling as three 'deci_tobits_round()' calls, in one pass.
+static void run_divmod_pow2(Bench *b)
+{
+    sink = deci_divmod_pow2(b->a, b->a + b->na, 3 * DECI_WORD_BITS, b->out);
+}
+
+static void run_shl10(Bench *b)
+{
+    b->a[b->na - 1] = 0;
+    sink = deci_shl10(b->a, b->a + b->na, 5);
+}
+
+static void run_shr10(Bench *b)
+{
+    sink = deci_shr10(b->a, b->a + b->na, 5, NULL);
+}
+
+static void run_shr10_round(Bench *b)
+{
+    sink = deci_shr10_round(b->a, b->a + b->na, 5, NULL);
+}
+
+static void run_sqrtrem(Bench *b)
+{
+    sink = deci_sqrtrem(b->a, b->a + b->na, b->out);
+}
+
+static void run_gcd(Bench *b)
+{
+    sink = deci_gcd(b->a, b->a + b->na, b->b, b->b + b->nb, b->scratch);
+}
+
+#if BENCH_WITH_GMP
+static void gmp_add(Bench *b)
+{
+    sink = mpn_add_n(b->ga, b->ga, b->gb, b->gn);
+}
+
+static void gmp_sub(Bench *b)
+{
+    sink = mpn_sub_n(b->ga, b->ga, b->gb, b->gn);
+}
+
+static void gmp_add_scaled(Bench *b)
+{
+    sink = mpn_addmul_1(b->gout, b->gb, b->gn, 123456);
+}
+
+static void gmp_sub_scaled(Bench *b)
+{
+    sink = mpn_submul_1(b->ga, b->gb, b->gn, 123456);
+}
+
+static void gmp_mul_uword(Bench *b)
+{
+    sink = mpn_mul_1(b->ga, b->ga, b->gn, 123456);
+}
+
+static void gmp_divmod_uword(Bench *b)
+{
+    sink = mpn_divrem_1(b->gout, 0, b->ga, b->gn, 7654);
+}
+
+static void gmp_mod_uword(Bench *b)
+{
+    sink = mpn_mod_1(b->ga, b->gn, 7654);
+}
+
+static void gmp_mul(Bench *b)
+{
+    mpn_mul_n(b->gout, b->ga, b->gb, b->gn);
+}
+
+static void gmp_divmod(Bench *b)
+{
+    // 'ga' has (2 * gn) limbs here.
+    mpn_tdiv_qr(b->gout, b->gscratch, 0, b->ga, 2 * b->gn, b->gb, b->gn);
+}
+
+static void gmp_sqrtrem(Bench *b)
+{
+    sink = mpn_sqrtrem(b->gout, b->gscratch, b->ga, b->gn);
+}
+
+static void gmp_gcd(Bench *b)
+{
+    // 'mpn_gcd' destroys its inputs, and wants the second one to be odd.
+    mpn_copyi(b->gout, b->ga, b->gn);
+    mpn_copyi(b->gscratch, b->gb, b->gn);
+    b->gscratch[0] |= 1;
+    sink = mpn_gcd(b->gout, b->gout, b->gn, b->gscratch, b->gn);
+}
+
+#   define GMP_FN(X_) , X_
+#else
+#   define GMP_FN(X_) /*nothing*/
+#endif
+
+static const Op OPS[] = {
+    {"add",               LINEAR,    false, NULL,         run_add               GMP_FN(gmp_add)},
+    {"sub_raw",           LINEAR,    false, NULL,         run_sub_raw           GMP_FN(gmp_sub)},
+    {"sub",               LINEAR,    false, NULL,         run_sub               GMP_FN(NULL)},
+    {"uncomplement",      LINEAR,    false, NULL,         run_uncomplement      GMP_FN(NULL)},
+    {"sub_mixed",         LINEAR,    true,  NULL,         run_sub_mixed         GMP_FN(NULL)},
+    {"absdiff_mixed",     LINEAR,    true,  NULL,         run_absdiff_mixed     GMP_FN(NULL)},
+    {"absdiff_out_mixed", LINEAR,    false, NULL,         run_absdiff_out_mixed GMP_FN(NULL)},
+    {"add_scaled",        LINEAR,    false, NULL,         run_add_scaled        GMP_FN(gmp_add_scaled)},
+    {"sub_scaled_raw",    LINEAR,    false, NULL,         run_sub_scaled_raw    GMP_FN(gmp_sub_scaled)},
+    {"mul_uword",         LINEAR,    false, NULL,         run_mul_uword         GMP_FN(gmp_mul_uword)},
+    {"divmod_uword",      LINEAR,    true,  NULL,         run_divmod_uword      GMP_FN(gmp_divmod_uword)},
+    {"divexact_uword",    LINEAR,    true,  init_divexact_uword, run_divexact_uword GMP_FN(NULL)},
+    {"mod_uword",         LINEAR,    false, NULL,         run_mod_uword         GMP_FN(gmp_mod_uword)},
+    {"mod_uword_multi",   LINEAR,    false, NULL,         run_mod_uword_multi   GMP_FN(NULL)},
+    {"mod_uword_x16",     LINEAR,    false, NULL,         run_mod_uword_x16     GMP_FN(NULL)},
+    {"tobits_round",      LINEAR,    true,  NULL,         run_tobits_round      GMP_FN(NULL)},
+    {"to_double",         LINEAR,    false, NULL,         run_to_double         GMP_FN(NULL)},
+    {"tolong",            LINEAR,    false, NULL,         run_tolong            GMP_FN(NULL)},
+    {"long_tobits_round", LINEAR,    false, NULL,         run_long_tobits_round GMP_FN(NULL)},
+    {"frombits_round",    LINEAR,    false, NULL,         run_frombits_round    GMP_FN(NULL)},
+    {"mul_pow2",          LINEAR,    true,  NULL,         run_mul_pow2          GMP_FN(NULL)},
+    {"divmod_pow2",       LINEAR,    true,  NULL,         run_divmod_pow2       GMP_FN(NULL)},
+    {"shl10",             LINEAR,    true,  NULL,         run_shl10             GMP_FN(NULL)},
+    {"shr10",             LINEAR,    true,  NULL,         run_shr10             GMP_FN(NULL)},
+    {"shr10_round",       LINEAR,    true,  NULL,         run_shr10_round       GMP_FN(NULL)},
+    {"pack",              LINEAR,    false, NULL,         run_pack              GMP_FN(NULL)},
+    {"unpack",            LINEAR,    false, init_unpack,  run_unpack            GMP_FN(NULL)},
+    {"regroup",           LINEAR,    false, NULL,         run_regroup           GMP_FN(NULL)},
+    {"div_short",         LINEAR,    true,  init_div_short, run_div         GMP_FN(NULL)},
+    {"div_dword",         LINEAR,    true,  init_div_dword, run_div         GMP_FN(NULL)},
+    {"div_tword",         LINEAR,    true,  init_div_tword, run_div         GMP_FN(NULL)},
+    {"div_appr",          LINEAR,    false, init_div_short, run_div_appr    GMP_FN(NULL)},
+    {"quotient",          LINEAR,    false, init_div_short, run_quotient    GMP_FN(NULL)},
+    {"mul",               QUADRATIC, false, NULL,         run_mul               GMP_FN(gmp_mul)},
+    {"mul_inplace",       QUADRATIC, true,  NULL,         run_mul_inplace       GMP_FN(gmp_mul)},
+    {"mullo",             QUADRATIC, false, NULL,         run_mullo             GMP_FN(gmp_mul)},
+    {"mullo_add",         QUADRATIC, true,  NULL,         run_mullo_add         GMP_FN(gmp_mul)},
+    {"mulhi",             QUADRATIC, false, NULL,         run_mulhi             GMP_FN(gmp_mul)},
+    {"mulhi_exact",       QUADRATIC, false, NULL,         run_mulhi_exact       GMP_FN(gmp_mul)},
+    {"prod_uwords",       QUADRATIC, false, init_factors, run_prod_uwords       GMP_FN(NULL)},
+    {"prod_uwords_seq",   QUADRATIC, false, init_factors, run_prod_uwords_seq   GMP_FN(NULL)},
+    {"factorial",         QUADRATIC, false, NULL,         run_factorial         GMP_FN(NULL)},
+    {"binomial",          QUADRATIC, false, NULL,         run_binomial          GMP_FN(NULL)},
+    {"pow",               QUADRATIC, false, NULL,         run_pow               GMP_FN(NULL)},
+    {"pow2",              QUADRATIC, false, NULL,         run_pow2              GMP_FN(NULL)},
+    {"pow2_seq",          QUADRATIC, false, NULL,         run_pow2_seq          GMP_FN(NULL)},
+    {"mul_steps",         QUADRATIC, false, NULL,         run_mul_steps         GMP_FN(NULL)},
+    {"divmod_unsafe",     QUADRATIC, true,  init_div_big, run_divmod_unsafe     GMP_FN(gmp_divmod)},
+    {"divmod_steps",      QUADRATIC, true,  init_div_big, run_divmod_steps      GMP_FN(NULL)},
+    {"div",               QUADRATIC, true,  init_div,     run_div               GMP_FN(gmp_divmod)},
+    {"mod",               QUADRATIC, true,  init_div,     run_mod               GMP_FN(gmp_divmod)},
+    {"divexact",          QUADRATIC, true,  init_divexact, run_divexact        GMP_FN(gmp_divmod)},
+    {"divrem",            QUADRATIC, false, init_div,     run_divrem            GMP_FN(gmp_divmod)},
+    {"sqrtrem",           QUADRATIC, true,  NULL,         run_sqrtrem           GMP_FN(gmp_sqrtrem)},
+    {"tobits_steps",      QUADRATIC, true,  NULL,         run_tobits_steps      GMP_FN(NULL)},
+    {"gcd",               QUADRATIC, true,  init_gcd,     run_gcd               GMP_FN(gmp_gcd)},
+};
+
+// --- driver -----------------------------------------------------------------------------
+
+static double min_time_ns = 20e6;
+
+static void reset(Bench *b)
+{
+    deci_memcpy(b->a, b->a0, b->na);
+    deci_memcpy(b->b, b->b0, b->nb);
+}
+
+// Returns the average time, in nanoseconds, that a call to 'run' (if not NULL) preceded by
+// 'reset' (if 'with_reset') takes.
+static double measure(Bench *b, void (*run)(Bench *), bool with_reset)
+{
+    for (size_t iters = 1; ; iters *= 2) {
+        const double t0 = now_ns();
+        for (size_t i = 0; i < iters; ++i) {
+            if (with_reset)
+                reset(b);
+            if (run)
+                run(b);
+        }
+        const double elapsed = now_ns() - t0;
+        if (elapsed >= min_time_ns)
+            return elapsed / iters;
+    }
+}
+
+static double measure_op(Bench *b, void (*run)(Bench *), bool destructive)
+{
+    reset(b);
+    if (!destructive)
+        return measure(b, run, false);
+    const double t = measure(b, run, true) - measure(b, NULL, true);
+    return t > 0 ? t : 0;
+}
+
+static double cycles_per_ns(void)
+{
+#if HAVE_RDTSC
+    const double t0 = now_ns();
+    const uint64_t c0 = __rdtsc();
+    while (now_ns() - t0 < 50e6) {
+    }
+    const uint64_t c1 = __rdtsc();
+    const double t1 = now_ns();
+    return (c1 - c0) / (t1 - t0);
+#else
+    return 0;
+#endif
+}
+
+static void bench_alloc(Bench *b, size_t n)
+{
+    const size_t cap = 2 * n + 4;
+    b->a = x_calloc(cap, sizeof(deci_UWORD));
+    b->a0 = x_calloc(cap, sizeof(deci_UWORD));
+    b->b = x_calloc(cap, sizeof(deci_UWORD));
+    b->b0 = x_calloc(cap, sizeof(deci_UWORD));
+    b->out = x_calloc(cap, sizeof(deci_UWORD));
+    b->scratch = x_calloc(cap, sizeof(deci_UWORD));
+    b->d = x_calloc(cap, sizeof(deci_DOUBLE_UWORD));
+#if BENCH_WITH_GMP
+    // Number of limbs to hold 'n' words: n * log2(DECI_BASE) bits.
+    b->gn = (mp_size_t) ceil(n * log2((double) DECI_BASE) / GMP_NUMB_BITS);
+    if (b->gn < 1)
+        b->gn = 1;
+    const size_t gcap = 2 * b->gn + 4;
+    b->ga = x_calloc(gcap, sizeof(mp_limb_t));
+    b->gb = x_calloc(gcap, sizeof(mp_limb_t));
+    b->gout = x_calloc(gcap, sizeof(mp_limb_t));
+    b->gscratch = x_calloc(gcap, sizeof(mp_limb_t));
+    for (size_t i = 0; i < gcap; ++i) {
+        b->ga[i] = rng_next();
+        b->gb[i] = rng_next();
+    }
+    b->gb[b->gn - 1] |= 1;
+#endif
+}
+
+static void bench_free(Bench *b)
+{
+    free(b->a);
+    free(b->a0);
+    free(b->b);
+    free(b->b0);
+    free(b->out);
+    free(b->scratch);
+    free(b->d);
+#if BENCH_WITH_GMP
+    free(b->ga);
+    free(b->gb);
+    free(b->gout);
+    free(b->gscratch);
+#endif
+}
+
+// Replaces 'a0' with a random multiple of 'b0' that has at most 'na' words.
+static void make_multiple(Bench *b)
+{
+    const size_t nq = b->na - b->nb;
+    fill_random(b->scratch, nq);
+    deci_zero_out_n(b->a0, b->na);
+    deci_mul(b->scratch, b->scratch + nq, b->b0, b->b0 + b->nb, b->a0);
+}
+
+// Returns the 'step'-th element of the sequence 1, 2, 5, 10, 20, 50, 100, ...
+static size_t sweep_size(size_t step)
+{
+    static const size_t mantissas[] = {1, 2, 5};
+    size_t n = mantissas[step % 3];
+    for (step /= 3; step; --step)
+        n *= 10;
+    return n;
+}
+
+static bool op_selected(const char *name, char **names, int nnames)
+{
+    if (!nnames)
+        return true;
+    for (int i = 0; i < nnames; ++i)
+        if (strcmp(names[i], name) == 0)
+            return true;
+    return false;
+}
+
+static void print_usage(const char *me)
+{
+    if (!me)
+        me = "bench";
+    fprintf(stderr, "USAGE: %s [-l MAX_LINEAR] [-q MAX_QUADRATIC] [-t MIN_TIME_MS] [OP...]\n", me);
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_n[2] = {1000000, 10000};
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; ++i) {
+        if (i + 1 == argc) {
+            print_usage(argv[0]);
+            return 2;
+        }
+        const double value = atof(argv[i + 1]);
+        if (strcmp(argv[i], "-l") == 0) {
+            max_n[LINEAR] = value;
+        } else if (strcmp(argv[i], "-q") == 0) {
+            max_n[QUADRATIC] = value;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            min_time_ns = value * 1e6;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    char **names = argv + i;
+    const int nnames = argc - i;
+
+    const double cpn = cycles_per_ns();
+
+    printf("{\n");
+    printf("  \"word_bits\": %d,\n", (int) DECI_WORD_BITS);
+    printf("  \"base_log\": %d,\n", (int) DECI_BASE_LOG);
+    printf("  \"results\": [");
+
+    bool first = true;
+    for (size_t k = 0; k < sizeof(OPS) / sizeof(OPS[0]); ++k) {
+        const Op *op = &OPS[k];
+        if (!op_selected(op->name, names, nnames))
+            continue;
+
+        for (size_t step = 0; ; ++step) {
+            const size_t n = sweep_size(step);
+            if (n > max_n[op->complexity])
+                break;
+
+            Bench b = {0};
+            b.n = n;
+            b.na = n;
+            b.nb = n;
+            if (op->init)
+                op->init(&b);
+            bench_alloc(&b, b.na > b.nb ? b.na : b.nb);
+            fill_random(b.a0, b.na);
+            fill_random(b.b0, b.nb);
+            if (b.exact)
+                make_multiple(&b);
+            if (b.packed)
+                deci_pack(b.a0, b.a0 + b.na, (unsigned char *) b.d);
+            if (b.nonzero)
+                for (size_t i = 0; i < b.nb; ++i)
+                    if (!b.b0[i])
+                        b.b0[i] = 1;
+            deci_memcpy(b.out, b.a0, b.na);
+
+            const double ns = measure_op(&b, op->run, op->destructive);
+
+            printf("%s\n    {\"op\": \"%s\", \"n\": %zu, \"ns_per_call\": %.3f, \"ns_per_word\": %.4f",
+                   first ? "" : ",", op->name, n, ns, ns / n);
+            if (cpn)
+                printf(", \"cycles_per_word\": %.4f", ns * cpn / n);
+            else
+                printf(", \"cycles_per_word\": null");
+#if BENCH_WITH_GMP
+            if (op->run_gmp) {
+                const double gns = measure_op(&b, op->run_gmp, false);
+                printf(", \"gmp_limbs\": %ld, \"gmp_ns_per_call\": %.3f", (long) b.gn, gns);
+            }
+#endif
+            printf("}");
+            fflush(stdout);
+            first = false;
+
+            bench_free(&b);
+        }
+    }
+
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../deci.h"
+
+// Usage:
+//     small [-t MIN_TIME_MS]
+//
+// Times the core operations on operands of 1 to 4 words, the sizes being compile-time constants at
+// the call sites, as they usually are in code that works on small fixed-size numbers; and writes
+// the results to stdout as JSON, in the format of 'bench'.
+//
+// Built twice: as 'small_native', against the separately compiled 'deci.c', and as
+// 'small_header_only', in the header-only mode (see 'DECI_HEADER_ONLY' in 'deci.h'). The difference
+// between the two is what the call and the loop setup cost on such operands.
+
+enum { NOPERANDS = 1024 };
+
+static deci_UWORD xs[NOPERANDS][4];
+static deci_UWORD ys[NOPERANDS][4];
+static deci_UWORD acc[4];
+static deci_UWORD out[8];
+
+static volatile deci_DOUBLE_UWORD sink;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Each of the following runs an operation once per operand (or pair of operands) of 'n' words; they
+// are force-inlined into the 'run_*' functions below, so that 'n' is a constant there.
+
+static inline DECI_FORCE_INLINE
+void loop_add(size_t n)
+{
+    deci_DOUBLE_UWORD carries = 0;
+    for (size_t i = 0; i < NOPERANDS; ++i)
+        carries += deci_add(acc, acc + n, xs[i], xs[i] + n);
+    sink = carries;
+}
+
+static inline DECI_FORCE_INLINE
+void loop_sub_raw(size_t n)
+{
+    deci_DOUBLE_UWORD borrows = 0;
+    for (size_t i = 0; i < NOPERANDS; ++i)
+        borrows += deci_sub_raw(acc, acc + n, xs[i], xs[i] + n);
+    sink = borrows;
+}
+
+static inline DECI_FORCE_INLINE
+void loop_add_scaled(size_t n)
+{
+    // (out ... out + n) stays less than DECI_BASE^n, so the sum always fits into (n + 1) words.
+    deci_DOUBLE_UWORD sum = 0;
+    for (size_t i = 0; i < NOPERANDS; ++i) {
+        deci_add_scaled(out, xs[i][0], ys[i], ys[i] + n);
+        sum += out[n];
+        out[n] = 0;
+    }
+    sink = sum;
+}
+
+static inline DECI_FORCE_INLINE
+void loop_sub_scaled_raw(size_t n)
+{
+    deci_DOUBLE_UWORD borrows = 0;
+    for (size_t i = 0; i < NOPERANDS; ++i)
+        borrows += deci_sub_scaled_raw(acc, acc + n, xs[i][0], ys[i], ys[i] + n);
+    sink = borrows;
+}
+
+static inline DECI_FORCE_INLINE
+void loop_mul(size_t n)
+{
+    deci_DOUBLE_UWORD sum = 0;
+    for (size_t i = 0; i < NOPERANDS; ++i) {
+        deci_zero_out_n(out, 2 * n);
+        deci_mul(xs[i], xs[i] + n, ys[i], ys[i] + n, out);
+        sum += out[2 * n - 1];
+    }
+    sink = sum;
+}
+
+#define FOR_EACH_OP(X) \
+    X(add) \
+    X(sub_raw) \
+    X(add_scaled) \
+    X(sub_scaled_raw) \
+    X(mul)
+
+#define X(Name_) \
+    static void run_##Name_##_1(void) { loop_##Name_(1); } \
+    static void run_##Name_##_2(void) { loop_##Name_(2); } \
+    static void run_##Name_##_3(void) { loop_##Name_(3); } \
+    static void run_##Name_##_4(void) { loop_##Name_(4); }
+FOR_EACH_OP(X)
+#undef X
+
+typedef struct {
+    const char *name;
+    size_t n;
+    void (*run)(void);
+} Op;
+
+static const Op OPS[] = {
+#define X(Name_) \
+    {#Name_, 1, run_##Name_##_1}, \
+    {#Name_, 2, run_##Name_##_2}, \
+    {#Name_, 3, run_##Name_##_3}, \
+    {#Name_, 4, run_##Name_##_4},
+FOR_EACH_OP(X)
+#undef X
+};
+
+static double min_time_ns = 20e6;
+
+// Returns the average time, in nanoseconds, that a single operation takes.
+static double measure(void (*run)(void))
+{
+    for (size_t iters = 1; ; iters *= 2) {
+        const double t0 = now_ns();
+        for (size_t i = 0; i < iters; ++i)
+            run();
+        const double elapsed = now_ns() - t0;
+        if (elapsed >= min_time_ns)
+            return elapsed / iters / NOPERANDS;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "-t") == 0) {
+        min_time_ns = atof(argv[2]) * 1e6;
+    } else if (argc != 1) {
+        fprintf(stderr, "USAGE: %s [-t MIN_TIME_MS]\n", argv[0] ? argv[0] : "small");
+        return 2;
+    }
+
+    for (size_t i = 0; i < NOPERANDS; ++i)
+        for (size_t j = 0; j < 4; ++j) {
+            xs[i][j] = rng_next() % DECI_BASE;
+            ys[i][j] = rng_next() % DECI_BASE;
+        }
+
+    printf("{\n");
+    printf("  \"word_bits\": %d,\n", (int) DECI_WORD_BITS);
+    printf("  \"base_log\": %d,\n", (int) DECI_BASE_LOG);
+    printf("  \"header_only\": %s,\n", DECI_HEADER_ONLY ? "true" : "false");
+    printf("  \"results\": [");
+    for (size_t k = 0; k < sizeof(OPS) / sizeof(OPS[0]); ++k) {
+        const double ns = measure(OPS[k].run);
+        printf("%s\n    {\"op\": \"%s\", \"n\": %zu, \"ns_per_call\": %.3f}",
+               k ? "," : "", OPS[k].name, OPS[k].n, ns);
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Usage:
+//     tune [-o FILE] [-t MIN_TIME_MS]
+//
+// Times the candidate values of every machine-dependent threshold on this host and writes the
+// fastest ones into FILE ('deci_tune.h' by default) as a header that 'deci.h' picks up. The
+// per-candidate timings are printed to stderr.
+//
+// The thresholds are compile-time constants in the library, so this program includes 'deci.c'
+// directly with each of them redirected to a variable that can be changed between measurements.
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DECI_NO_TUNE_H
+static size_t tune_gcd_lehmer_threshold;
+#define DECI_GCD_LEHMER_THRESHOLD tune_gcd_lehmer_threshold
+
+#include "../deci.c"
+
+typedef struct {
+    // Name of the macro in 'deci.h'.
+    const char *macro;
+    // The variable the macro is redirected to.
+    size_t *var;
+    // Candidate values, terminated by 0.
+    const size_t *candidates;
+    // Runs the operation affected by the threshold once.
+    void (*run)(void);
+    // Restores the input of 'run()', if it destroys it; may be NULL.
+    void (*reset)(void);
+} Tunable;
+
+static volatile size_t sink;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill_random(deci_UWORD *w, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        w[i] = rng_next() % DECI_BASE;
+    if (n && !w[n - 1])
+        w[n - 1] = 1;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// --- gcd ----------------------------------------------------------------------------------
+//
+// Every gcd computation on long operands ends up going through all the shorter sizes, so timing a
+// single size well above the largest candidate covers all of them.
+
+enum { GCD_N = 64 };
+
+static deci_UWORD gcd_a[GCD_N], gcd_a0[GCD_N];
+static deci_UWORD gcd_b[GCD_N], gcd_b0[GCD_N];
+static deci_UWORD gcd_scratch[GCD_N];
+
+static const size_t gcd_candidates[] = {2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 0};
+
+static void gcd_reset(void)
+{
+    deci_memcpy(gcd_a, gcd_a0, GCD_N);
+    deci_memcpy(gcd_b, gcd_b0, GCD_N);
+}
+
+static void gcd_run(void)
+{
+    sink = deci_gcd(gcd_a, gcd_a + GCD_N, gcd_b, gcd_b + GCD_N, gcd_scratch);
+}
+
+static void gcd_init(void)
+{
+    fill_random(gcd_a0, GCD_N);
+    fill_random(gcd_b0, GCD_N);
+}
+
+// ------------------------------------------------------------------------------------------
+
+static const Tunable tunables[] = {
+    {"DECI_GCD_LEHMER_THRESHOLD", &tune_gcd_lehmer_threshold, gcd_candidates, gcd_run, gcd_reset},
+};
+
+enum { NTUNABLES = sizeof(tunables) / sizeof(tunables[0]) };
+
+// Returns the time of one call of 'run()' in nanoseconds, including 'reset()'.
+static double measure_once(const Tunable *t, double min_time_ns)
+{
+    size_t iters = 0;
+    const double start = now_ns();
+    double elapsed;
+    do {
+        if (t->reset)
+            t->reset();
+        t->run();
+        ++iters;
+    } while ((elapsed = now_ns() - start) < min_time_ns);
+    return elapsed / iters;
+}
+
+// Returns the candidate with the smallest time; the time of each one is the minimum over several
+// rounds, with the candidates interleaved so that a transient slowdown does not favor any of them.
+static size_t tune(const Tunable *t, double min_time_ns)
+{
+    enum { ROUNDS = 5 };
+
+    size_t ncandidates = 0;
+    while (t->candidates[ncandidates])
+        ++ncandidates;
+
+    double *best = calloc(ncandidates, sizeof(double));
+    if (!best) {
+        fputs("Out of memory.\n", stderr);
+        abort();
+    }
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < ncandidates; ++i) {
+            *t->var = t->candidates[i];
+            const double ns = measure_once(t, min_time_ns);
+            if (!round || ns < best[i])
+                best[i] = ns;
+        }
+    }
+
+    size_t result = 0;
+    for (size_t i = 0; i < ncandidates; ++i) {
+        fprintf(stderr, "%s = %zu: %.1f ns\n", t->macro, t->candidates[i], best[i]);
+        if (best[i] < best[result])
+            result = i;
+    }
+    free(best);
+    return t->candidates[result];
+}
+
+static void usage(void)
+{
+    fputs("USAGE: tune [-o FILE] [-t MIN_TIME_MS]\n", stderr);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = "deci_tune.h";
+    double min_time_ms = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc)
+            usage();
+        if (strcmp(argv[i], "-o") == 0)
+            out_path = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0)
+            min_time_ms = atof(argv[++i]);
+        else
+            usage();
+    }
+
+    gcd_init();
+
+    size_t values[NTUNABLES];
+    for (size_t i = 0; i < NTUNABLES; ++i)
+        values[i] = tune(&tunables[i], min_time_ms * 1e6);
+
+    FILE *f = fopen(out_path, "w");
+    if (!f) {
+        perror(out_path);
+        return 1;
+    }
+    fprintf(f, "// Generated by 'bench/tune' for the %d-bit configuration; do not edit.\n",
+            DECI_WE_ARE_64_BIT ? 64 : 32);
+    fputs("// Delete this file to go back to the defaults from 'deci.h'.\n", f);
+    fputs("\n#pragma once\n\n", f);
+    fprintf(f, "#if %sDECI_WE_ARE_64_BIT\n", DECI_WE_ARE_64_BIT ? "" : "! ");
+    for (size_t i = 0; i < NTUNABLES; ++i) {
+        fprintf(f, "#   if ! defined(%s)\n", tunables[i].macro);
+        fprintf(f, "#       define %s %zu\n", tunables[i].macro, values[i]);
+        fputs("#   endif\n", f);
+    }
+    fputs("#endif\n", f);
+
+    if (fclose(f) != 0) {
+        perror(out_path);
+        return 1;
+    }
+    return 0;
+}
@@ -17,6 +17,8 @@
  * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+// Keeps 'deci.h' from including this file again in the header-only mode.
+#define DECI_C_
 #include "deci.h"
 
 #define SWAP(Type_, X_, Y_) \
@@ -31,6 +33,74 @@ typedef deci_UWORD BORROW;
 #define CARRY_TO_1BIT(X_)  (-(deci_UWORD) (X_))
 #define BORROW_TO_1BIT(X_) (-(deci_UWORD) (X_))
 
+#if DECI_STATS
+
+#   if defined(__cplusplus) && __cplusplus >= 201103L
+#       define STATS_THREAD_LOCAL thread_local
+#   elif defined(_MSC_VER)
+#       define STATS_THREAD_LOCAL __declspec(thread)
+#   elif defined(__GNUC__)
+#       define STATS_THREAD_LOCAL __thread
+#   else
+#       define STATS_THREAD_LOCAL _Thread_local
+#   endif
+
+static STATS_THREAD_LOCAL deci_Stats stats;
+
+static unsigned stats_bucket(uint64_t x)
+{
+    unsigned i = 0;
+    for (; x && i != DECI_STATS_NBUCKETS - 1; x >>= 1)
+        ++i;
+    return i;
+}
+
+static void stats_call(deci_StatsEntry entry, size_t nwords)
+{
+    ++stats.calls[entry];
+    stats.words[entry] += nwords;
+    ++stats.sizes[entry][stats_bucket(nwords)];
+}
+
+static void stats_tail(uint64_t *histogram, size_t n)
+{
+    ++histogram[stats_bucket(n)];
+}
+
+DECI_API
+void deci_stats_snapshot(deci_Stats *out)
+{
+    *out = stats;
+}
+
+DECI_API
+void deci_stats_reset(void)
+{
+    // Not 'const': C++ does not allow const objects without an initializer.
+    static deci_Stats zero;
+    stats = zero;
+}
+
+DECI_API
+const char *deci_stats_entry_name(deci_StatsEntry entry)
+{
+    static const char *const names[] = {
+#define X(Upper_, Lower_) #Lower_,
+    DECI_STATS_FOR_EACH_ENTRY(X)
+#undef X
+    };
+    return names[entry];
+}
+
+// Expands to its arguments if the statistics are enabled, and to nothing otherwise.
+#   define STATS(...) __VA_ARGS__
+
+#else
+
+#   define STATS(...) /*nothing*/
+
+#endif
+
 // add with carry
 static inline DECI_FORCE_INLINE
 CARRY adc(deci_UWORD *a, deci_UWORD b, CARRY carry)
@@ -56,50 +126,107 @@ BORROW sbb(deci_UWORD *a, deci_UWORD b, BORROW borrow)
     return result;
 }
 
-bool deci_add(
+static inline DECI_FORCE_INLINE
+bool add_impl(
         deci_UWORD *wa, deci_UWORD *wa_end,
-        deci_UWORD *wb, deci_UWORD *wb_end)
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        CARRY carry)
 {
-    CARRY carry = 0;
     for (; wb != wb_end; ++wb, ++wa)
         carry = adc(wa, *wb, carry);
 
-    if (!carry)
+    if (!carry) {
+        STATS(stats_tail(stats.add_carry_tails, 0);)
         return false;
+    }
 
+    STATS(deci_UWORD *const tail = wa;)
     for (; wa != wa_end; ++wa) {
         if (*wa != DECI_BASE - 1) {
             ++*wa;
+            STATS(stats_tail(stats.add_carry_tails, wa - tail + 1);)
             return false;
         }
         *wa = 0;
     }
+    STATS(stats_tail(stats.add_carry_tails, wa - tail);)
     return true;
 }
 
-bool deci_sub_raw(
+DECI_API
+bool deci_add(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end)
 {
-    BORROW borrow = 0;
+    STATS(stats_call(DECI_STATS_ADD, (wa_end - wa) + (wb_end - wb));)
+
+    return add_impl(wa, wa_end, wb, wb_end, 0);
+}
+
+DECI_API
+bool deci_add_chunk(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        bool carry)
+{
+    STATS(stats_call(DECI_STATS_ADD_CHUNK, (wa_end - wa) + (wb_end - wb));)
+
+    return add_impl(wa, wa_end, wb, wb_end, -(CARRY) carry);
+}
+
+static inline DECI_FORCE_INLINE
+bool sub_raw_impl(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        BORROW borrow)
+{
     for (; wb != wb_end; ++wb, ++wa)
         borrow = sbb(wa, *wb, borrow);
 
-    if (!borrow)
+    if (!borrow) {
+        STATS(stats_tail(stats.sub_borrow_tails, 0);)
         return false;
+    }
 
+    STATS(deci_UWORD *const tail = wa;)
     for (; wa != wa_end; ++wa) {
         if (*wa) {
             --*wa;
+            STATS(stats_tail(stats.sub_borrow_tails, wa - tail + 1);)
             return false;
         }
         *wa = DECI_BASE - 1;
     }
+    STATS(stats_tail(stats.sub_borrow_tails, wa - tail);)
     return true;
 }
 
+DECI_API
+bool deci_sub_raw(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end)
+{
+    STATS(stats_call(DECI_STATS_SUB_RAW, (wa_end - wa) + (wb_end - wb));)
+
+    return sub_raw_impl(wa, wa_end, wb, wb_end, 0);
+}
+
+DECI_API
+bool deci_sub_raw_chunk(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        bool borrow)
+{
+    STATS(stats_call(DECI_STATS_SUB_RAW_CHUNK, (wa_end - wa) + (wb_end - wb));)
+
+    return sub_raw_impl(wa, wa_end, wb, wb_end, -(BORROW) borrow);
+}
+
+DECI_API
 bool deci_uncomplement(deci_UWORD *wa, deci_UWORD *wa_end)
 {
+    STATS(stats_call(DECI_STATS_UNCOMPLEMENT, wa_end - wa);)
+
     for (; wa != wa_end; ++wa)
         if (*wa)
             goto nonzero;
@@ -112,13 +239,92 @@ nonzero:
     return true;
 }
 
-void deci_add_scaled(
+// Writes (wx ... wx + n) minus (wy ... wy + n) into (out ... out + n), returning the borrow flag;
+// 'out' may be equal to 'wx' or 'wy'.
+static inline DECI_FORCE_INLINE
+bool sub_out_run(deci_UWORD *wx, deci_UWORD *wy, size_t n, deci_UWORD *out)
+{
+    BORROW borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const deci_UWORD y = wy[i];
+        out[i] = wx[i];
+        borrow = sbb(out + i, y, borrow);
+    }
+    return borrow;
+}
+
+static inline DECI_FORCE_INLINE
+bool absdiff_impl(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *out)
+{
+    const size_t na = wa_end - wa;
+    const size_t nb = wb_end - wb;
+
+    size_t n = na;
+    while (n != nb && !wa[n - 1])
+        --n;
+    if (n != nb) {
+        // 'a' is longer, so the borrow out of 'b' stops within it.
+        size_t i = nb;
+        if (sub_out_run(wa, wb, nb, out)) {
+            for (; !wa[i]; ++i)
+                out[i] = DECI_BASE - 1;
+            out[i] = wa[i] - 1;
+            ++i;
+        }
+        if (out != wa)
+            deci_memcpy(out + i, wa + i, na - i);
+        return false;
+    }
+
+    while (n && wa[n - 1] == wb[n - 1])
+        --n;
+    deci_zero_out(out + n, out + na);
+    if (!n)
+        return false;
+
+    const bool less = wa[n - 1] < wb[n - 1];
+    if (less)
+        (void) sub_out_run(wb, wa, n, out);
+    else
+        (void) sub_out_run(wa, wb, n, out);
+    return less;
+}
+
+DECI_API
+bool deci_absdiff(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end)
+{
+    STATS(stats_call(DECI_STATS_ABSDIFF, (wa_end - wa) + (wb_end - wb));)
+
+    return absdiff_impl(wa, wa_end, wb, wb_end, wa);
+}
+
+DECI_API
+bool deci_absdiff_out(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_ABSDIFF_OUT, (wa_end - wa) + (wb_end - wb));)
+
+    return absdiff_impl(wa, wa_end, wb, wb_end, out);
+}
+
+// Adds ((wz ... wz_end) times 'y') to (wx ... wx + (wz_end - wz)), given the carries from the
+// lower words; returns the multiplication carry, updating '*add_carry'.
+static inline DECI_FORCE_INLINE
+deci_UWORD add_scaled_run(
         deci_UWORD *wx,
         deci_UWORD y,
-        deci_UWORD *wz, deci_UWORD *wz_end)
+        deci_UWORD *wz, deci_UWORD *wz_end,
+        deci_UWORD mul_carry,
+        CARRY *add_carry)
 {
-    deci_UWORD mul_carry = 0;
-    CARRY add_carry = 0;
+    CARRY carry = *add_carry;
 
     for (; wz != wz_end; ++wz) {
         const deci_DOUBLE_UWORD x = *wz * ((deci_DOUBLE_UWORD) y) + mul_carry;
@@ -127,10 +333,18 @@ void deci_add_scaled(
 
         mul_carry = x / DECI_BASE;
 
-        add_carry = adc(wx, w, add_carry);
+        carry = adc(wx, w, carry);
         ++wx;
     }
 
+    *add_carry = carry;
+    return mul_carry;
+}
+
+// Adds the carries left by 'add_scaled_run()' to (wx ...).
+static inline DECI_FORCE_INLINE
+void add_scaled_finish(deci_UWORD *wx, deci_UWORD mul_carry, CARRY add_carry)
+{
     if (mul_carry) {
         add_carry = adc(wx, mul_carry, add_carry);
         ++wx;
@@ -143,11 +357,27 @@ void deci_add_scaled(
     }
 }
 
+DECI_API
+void deci_add_scaled(
+        deci_UWORD *wx,
+        deci_UWORD y,
+        deci_UWORD *wz, deci_UWORD *wz_end)
+{
+    STATS(stats_call(DECI_STATS_ADD_SCALED, wz_end - wz);)
+
+    CARRY add_carry = 0;
+    const deci_UWORD mul_carry = add_scaled_run(wx, y, wz, wz_end, 0, &add_carry);
+    add_scaled_finish(wx + (wz_end - wz), mul_carry, add_carry);
+}
+
+DECI_API
 void deci_mul(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end,
         deci_UWORD *out)
 {
+    STATS(stats_call(DECI_STATS_MUL, (wa_end - wa) + (wb_end - wb));)
+
     // Our loop is optimized for long 'a' and short 'b', so swap if 'a' is shorter.
     if ((wa_end - wa) < (wb_end - wb)) {
         SWAP(deci_UWORD *, wa, wb);
@@ -157,6 +387,312 @@ void deci_mul(
         deci_add_scaled(out, *wb, wa, wa_end);
 }
 
+DECI_API
+void deci_mul_inplace(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end)
+{
+    STATS(stats_call(DECI_STATS_MUL_INPLACE, (wa_end - wa) + (wb_end - wb));)
+
+    const size_t nwb = wb_end - wb;
+    if (nwb == 0) {
+        deci_zero_out(wa, wa_end);
+        return;
+    }
+    if (nwb == 1) {
+        *wa_end = deci_mul_uword(wa, wa_end, *wb);
+        return;
+    }
+
+    deci_zero_out_n(wa_end, nwb);
+
+    // Go from the most significant word of 'a' down, adding (word times 'b') at its position. The
+    // partial product so far is that of the words above, and so only occupies the words above:
+    // the current word can be taken out, and its place reused.
+    while (wa_end != wa) {
+        --wa_end;
+        const deci_UWORD x = *wa_end;
+        if (!x)
+            continue;
+        *wa_end = 0;
+        CARRY add_carry = 0;
+        const deci_UWORD mul_carry = add_scaled_run(wa_end, x, wb, wb_end, 0, &add_carry);
+        add_scaled_finish(wa_end + nwb, mul_carry, add_carry);
+    }
+}
+
+// Writes ((wa ... wa + n) times (wb ... wb + n) plus 'c') modulo (DECI_BASE^n) over 'a'; if 'wc' is
+// NULL, 'c' is taken to be zero. Goes from the most significant word of 'a' down, as
+// 'deci_mul_inplace()' does, and puts the word of 'c' in the place taken out, so that 'c' is added
+// for free; the carries out of the top word are dropped.
+static void mullo_inplace(
+        deci_UWORD *wa,
+        deci_UWORD *wb,
+        deci_UWORD *wc,
+        size_t n)
+{
+    for (size_t i = n; i;) {
+        --i;
+        const deci_UWORD x = wa[i];
+        wa[i] = wc ? wc[i] : 0;
+        if (!x)
+            continue;
+        CARRY add_carry = 0;
+        (void) add_scaled_run(wa + i, x, wb, wb + (n - i), 0, &add_carry);
+    }
+}
+
+DECI_API
+void deci_mullo(
+        deci_UWORD *wa,
+        deci_UWORD *wb,
+        size_t n,
+        deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_MULLO, 2 * n);)
+
+    if (out == wb)
+        SWAP(deci_UWORD *, wa, wb);
+    if (out != wa)
+        deci_memcpy(out, wa, n);
+    mullo_inplace(out, wb, NULL, n);
+}
+
+DECI_API
+void deci_mullo_add(
+        deci_UWORD *wa,
+        deci_UWORD *wb,
+        deci_UWORD *wc,
+        size_t n)
+{
+    STATS(stats_call(DECI_STATS_MULLO_ADD, 3 * n);)
+
+    mullo_inplace(wa, wb, wc, n);
+}
+
+// ---------------------------------------------------------------------------------------
+// Short products.
+//
+// Let the product P of an N-word 'a' by an M-word 'b' be wanted only from the word T up, and let
+// S be the sum of the partial products (a_i b_j B^(i+j)) with (i + j >= T), all multiples of B^T.
+// What is left out is
+//     L = P - S = sum of a_i b_j B^(i+j) over (i + j < T),
+// and each of the columns (i + j = c) has at most m = min(N, M) terms, each at most (B - 1)^2, so
+//     L <= m (B - 1)^2 (B^(T-1) + ... + 1) < m (B - 1) B^T.
+// Hence (S / B^T) <= floor(P / B^T) < (S / B^T) + m B. With T taken 'DECI_MULHI_GUARD' words below
+// the wanted ones, and m < B^(DECI_MULHI_GUARD - 1), the error is less than one unit of the least
+// significant of the wanted words; it reaches into them only if the guard words are close enough
+// to all nines, and then 'deci_mulhi_exact()' computes L to fix them up.
+// ---------------------------------------------------------------------------------------
+
+// Writes (S / B^T) into (out ... out + n + DECI_MULHI_GUARD), see above; if T is negative, the
+// product is written shifted up by (-T) words, with zeros below it.
+static void mulhi_impl(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        size_t n,
+        deci_UWORD *out)
+{
+    const size_t nwa = wa_end - wa;
+    const size_t nwb = wb_end - wb;
+    const size_t nout = n + DECI_MULHI_GUARD;
+
+    deci_zero_out_n(out, nout);
+
+    if (nwa + nwb <= nout) {
+        deci_mul(wa, wa_end, wb, wb_end, out + (nout - (nwa + nwb)));
+        return;
+    }
+
+    const size_t t = (nwa + nwb) - nout;
+    // The words of 'b' that are at least 't' words up need all of 'a'; the lower ones, only the
+    // words of 'a' from (t - j) up.
+    for (size_t j = 0; j < nwb; ++j) {
+        const size_t i = j < t ? t - j : 0;
+        if (i < nwa)
+            deci_add_scaled(out + (i + j - t), wb[j], wa + i, wa_end);
+    }
+}
+
+DECI_API
+void deci_mulhi(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        size_t n,
+        deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_MULHI, (wa_end - wa) + (wb_end - wb));)
+
+    mulhi_impl(wa, wa_end, wb, wb_end, n, out);
+}
+
+DECI_API
+void deci_mulhi_exact(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        size_t n,
+        deci_UWORD *out,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_MULHI_EXACT, (wa_end - wa) + (wb_end - wb));)
+
+    mulhi_impl(wa, wa_end, wb, wb_end, n, out);
+
+    const size_t nwa = wa_end - wa;
+    const size_t nwb = wb_end - wb;
+    const size_t nout = n + DECI_MULHI_GUARD;
+
+    if (nwa + nwb > nout) {
+        // The guard words can only overflow into the wanted ones if they are at least
+        // (B^DECI_MULHI_GUARD - m B).
+        deci_QUAD_UWORD guard = 0;
+        deci_QUAD_UWORD guard_end = 1;
+        for (size_t i = DECI_MULHI_GUARD; i;) {
+            guard = guard * DECI_BASE + out[--i];
+            guard_end *= DECI_BASE;
+        }
+        const deci_QUAD_UWORD m = nwa < nwb ? nwa : nwb;
+        if (m * DECI_BASE >= guard_end || guard >= guard_end - m * DECI_BASE) {
+            // Compute L into (scratch ... scratch + t + DECI_MULHI_GUARD), and add its words from
+            // 't' up to the guard words.
+            const size_t t = (nwa + nwb) - nout;
+            deci_zero_out_n(scratch, t + DECI_MULHI_GUARD);
+            for (size_t j = 0; j < nwb && j < t; ++j) {
+                const size_t na_low = t - j < nwa ? t - j : nwa;
+                deci_add_scaled(scratch + j, wb[j], wa, wa + na_low);
+            }
+            (void) deci_add(out, out + nout, scratch + t, scratch + t + DECI_MULHI_GUARD);
+        }
+    }
+
+    deci_memmove(out, out + DECI_MULHI_GUARD, n);
+}
+
+// ---------------------------------------------------------------------------------------
+// Products of many factors.
+//
+// The factors are first packed into "leaves", two-word values less than B^2, each the product of
+// as many consecutive factors as fit. The leaves are then multiplied pairwise, level by level, up a
+// balanced tree. On the level where each slot holds the product of 'w / 2' leaves, the slot i
+// occupies the words (i w ... (i + 1) w) of the buffer, except that the last slot may be shorter;
+// the product of two adjacent slots takes exactly the words of both in the other buffer, so each
+// level fits into (2 m) words for 'm' leaves, and the operands of every multiplication are of about
+// the same size.
+// ---------------------------------------------------------------------------------------
+
+typedef struct {
+    deci_UWORD *out;
+    size_t nleaves;
+    deci_DOUBLE_UWORD leaf;
+} Leaves;
+
+static inline DECI_FORCE_INLINE
+void leaves_flush(Leaves *lv)
+{
+    lv->out[2 * lv->nleaves] = lv->leaf % DECI_BASE;
+    lv->out[2 * lv->nleaves + 1] = lv->leaf / DECI_BASE;
+    ++lv->nleaves;
+}
+
+// Multiplies the current leaf by 'f', or starts a new one with it if the product would not be less
+// than B^2. Assumes (0 < f < B^2).
+static inline DECI_FORCE_INLINE
+void leaves_push(Leaves *lv, deci_DOUBLE_UWORD f)
+{
+    const deci_DOUBLE_UWORD base_sq = ((deci_DOUBLE_UWORD) DECI_BASE) * DECI_BASE;
+    if (lv->leaf > (base_sq - 1) / f) {
+        leaves_flush(lv);
+        lv->leaf = f;
+    } else {
+        lv->leaf *= f;
+    }
+}
+
+// Multiplies the 'm' leaves in (x ... x + 2 m) up the tree, using (y ... y + 2 m) as the other
+// buffer, and writes the normalized product into 'out', which may be equal to 'x' or 'y'. Returns
+// its size.
+static size_t prod_tree(deci_UWORD *x, deci_UWORD *y, size_t m, deci_UWORD *out)
+{
+    const size_t n = 2 * m;
+    for (size_t w = 2; w < n; w *= 2) {
+        for (size_t i = 0; i < n; i += 2 * w) {
+            if (n - i <= w) {
+                deci_memcpy(y + i, x + i, n - i);
+                break;
+            }
+            const size_t nslot = n - i < 2 * w ? n - i : 2 * w;
+            deci_UWORD *a_end = deci_normalize(x + i, x + i + w);
+            deci_UWORD *b_end = deci_normalize(x + i + w, x + i + nslot);
+            deci_zero_out_n(y + i, nslot);
+            deci_mul(x + i, a_end, x + i + w, b_end, y + i);
+        }
+        SWAP(deci_UWORD *, x, y);
+    }
+
+    const size_t nr = deci_normalize_n(x, n);
+    if (x != out)
+        deci_memcpy(out, x, nr);
+    return nr;
+}
+
+DECI_API
+size_t deci_prod_uwords(const deci_UWORD *factors, size_t n, deci_UWORD *out, deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_PROD_UWORDS, n);)
+
+    Leaves lv = {out, 0, 1};
+    for (size_t i = 0; i < n; ++i) {
+        if (!factors[i])
+            return 0;
+        leaves_push(&lv, factors[i]);
+    }
+    leaves_flush(&lv);
+    return prod_tree(out, scratch, lv.nleaves, out);
+}
+
+// Writes the leaves of the product of all the integers in (lo ... hi], that is, greater than 'lo'
+// and not greater than 'hi', into (out ... out + 2 M), where M is the return value. Assumes
+// (hi < B^2).
+static size_t range_leaves(size_t lo, size_t hi, deci_UWORD *out)
+{
+    Leaves lv = {out, 0, 1};
+    for (size_t f = lo + 1; f <= hi; ++f)
+        leaves_push(&lv, (deci_DOUBLE_UWORD) f);
+    leaves_flush(&lv);
+    return lv.nleaves;
+}
+
+DECI_API
+size_t deci_factorial(size_t n, deci_UWORD *out, deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_FACTORIAL, deci_factorial_nwords_max(n));)
+
+    return prod_tree(out, scratch, range_leaves(1, n, out), out);
+}
+
+DECI_API
+size_t deci_binomial(size_t n, size_t k, deci_UWORD *out, deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_BINOMIAL, deci_binomial_nwords_max(n, k));)
+
+    if (k > n)
+        return 0;
+    if (k > n - k)
+        k = n - k;
+    if (!k) {
+        out[0] = 1;
+        return 1;
+    }
+
+    // The denominator, k!, is kept in the upper half of 'scratch'; the lower half is the other
+    // buffer for the numerator, and then the scratch space for the division.
+    const size_t half = deci_binomial_nwords_max(n, k);
+    deci_UWORD *den = scratch + half;
+    const size_t nden = prod_tree(den, out, range_leaves(1, k, den), den);
+    const size_t nnum = prod_tree(out, scratch, range_leaves(n - k, n, out), out);
+    return deci_divexact(out, out + nnum, den, den + nden, scratch);
+}
+
 // ---------------------------------------------------------------------------------------
 // For more info on the long division algorithm we use, see:
 //  * Knuth section 4.3.1 algorithm D
@@ -231,21 +767,41 @@ void deci_mul(
 //       * floor(q_min) = q, which implies q_min < q + 1.
 //     Combined, these statements imply u/v - q_min > 1, contradicting lemma 3.
 
-deci_UWORD deci_sub_scaled_raw(
-        deci_UWORD *wx, deci_UWORD *wx_end,
+// Subtracts ((wz ... wz_end) times 'y') from (wx ... wx + (wz_end - wz)), given the carry and
+// the borrow from the lower words; returns the multiplication carry, updating '*sub_borrow'.
+static inline DECI_FORCE_INLINE
+deci_UWORD sub_scaled_run(
+        deci_UWORD *wx,
         deci_UWORD y,
-        deci_UWORD *wz, deci_UWORD *wz_end)
+        deci_UWORD *wz, deci_UWORD *wz_end,
+        deci_UWORD mul_carry,
+        BORROW *sub_borrow)
 {
-    deci_UWORD mul_carry = 0;
-    BORROW sub_borrow = 0;
+    BORROW borrow = *sub_borrow;
 
     for (; wz != wz_end; ++wz, ++wx) {
         const deci_DOUBLE_UWORD x = (*wz * (deci_DOUBLE_UWORD) y) + mul_carry;
         const deci_UWORD r = x % DECI_BASE;
         mul_carry = x / DECI_BASE;
-        sub_borrow = sbb(wx, r, sub_borrow);
+        borrow = sbb(wx, r, borrow);
     }
 
+    *sub_borrow = borrow;
+    return mul_carry;
+}
+
+DECI_API
+deci_UWORD deci_sub_scaled_raw(
+        deci_UWORD *wx, deci_UWORD *wx_end,
+        deci_UWORD y,
+        deci_UWORD *wz, deci_UWORD *wz_end)
+{
+    STATS(stats_call(DECI_STATS_SUB_SCALED_RAW, (wx_end - wx) + (wz_end - wz));)
+
+    BORROW sub_borrow = 0;
+    const deci_UWORD mul_carry = sub_scaled_run(wx, y, wz, wz_end, 0, &sub_borrow);
+    wx += wz_end - wz;
+
     if (wx == wx_end)
         return mul_carry + BORROW_TO_1BIT(sub_borrow);
 
@@ -330,7 +886,10 @@ static inline deci_UWORD long_div_round(
             /*b12=*/b12);
     }
 
+    STATS(++stats.div_rounds;)
+
     if (deci_sub_scaled_raw(wr, wr_end, q, wb, wb_end)) {
+        STATS(++stats.div_corrections;)
         --q;
         (void) deci_add(wr, wr_end, wb, wb_end);
     }
@@ -338,10 +897,13 @@ static inline deci_UWORD long_div_round(
     return q;
 }
 
+DECI_API
 deci_UWORD deci_divmod_unsafe(
     deci_UWORD *wa, deci_UWORD *wa_end,
     deci_UWORD *wb, deci_UWORD *wb_end)
 {
+    STATS(stats_call(DECI_STATS_DIVMOD_UNSAFE, (wa_end - wa) + (wb_end - wb));)
+
     const size_t nwb = wb_end - wb;
 
     const deci_DOUBLE_UWORD b12 = combine(wb_end[-1], wb_end[-2]);
@@ -359,15 +921,142 @@ deci_UWORD deci_divmod_unsafe(
     return qhi;
 }
 
-size_t deci_div(
-    deci_UWORD *wa, deci_UWORD *wa_end,
-    deci_UWORD *wb, deci_UWORD *wb_end)
+// ---------------------------------------------------------------------------------------
+// Division by two- and three-word divisors.
+//
+// Let the divisor 'b' have L bits, so that 2^(L-1) <= b < 2^L, and let S = L - 1 and W be
+// 'DECI_WORD_BITS'. Its reciprocal is taken once as
+//     v = floor(2^(S+W) / b),    2^(W-1) < v <= 2^W.
+// Each round has the remainder 'r' of the previous one, r < b, and the next word 'w' of the
+// dividend, and has to find q = floor(x/b) for x = r B + w. As x < b B < 2^(S+1) B, the
+// value of X = floor(x / 2^S) is less than 2 B < 2^W, and the estimate
+//     q1 = floor(X v / 2^W)
+// fits into 'deci_DOUBLE_UWORD' along with the product. Then q - 2 <= q1 <= q:
+//
+//   * X <= x / 2^S and v <= 2^(S+W) / b, so X v / 2^W <= x/b;
+//
+//   * X > x / 2^S - 1 and v > 2^(S+W) / b - 1, so
+//         X v / 2^W > x/b - x / 2^(S+W) - 2^S / b >= x/b - 2 B / 2^W - 1 > x/b - 2,
+//     as 2^S <= b and B < 2^(W-1).
+//
+// The remainder (x - q1 b) is then less than 3 b, and is brought below 'b' by at most two
+// subtractions.
+
+static unsigned quad_bit_length(deci_QUAD_UWORD x)
 {
-    wa_end = deci_normalize(wa, wa_end);
-    wb_end = deci_normalize(wb, wb_end);
+    unsigned r = 0;
+    for (; x >> 16; x >>= 16)
+        r += 16;
+    for (; x; x >>= 1)
+        ++r;
+    return r;
+}
 
-    const size_t nwa = wa_end - wa;
-    const size_t nwb = wb_end - wb;
+DECI_API
+deci_DOUBLE_UWORD deci_divmod_dword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_DOUBLE_UWORD b)
+{
+    STATS(stats_call(DECI_STATS_DIVMOD_DWORD, wa_end - wa);)
+
+    const unsigned shift = quad_bit_length(b) - 1;
+    const deci_DOUBLE_UWORD v = (((deci_QUAD_UWORD) 1) << (shift + DECI_WORD_BITS)) / b;
+
+    deci_DOUBLE_UWORD r = 0;
+    while (wa_end != wa) {
+        --wa_end;
+        const deci_QUAD_UWORD x = r * (deci_QUAD_UWORD) DECI_BASE + *wa_end;
+        const deci_DOUBLE_UWORD xs = (deci_DOUBLE_UWORD) (x >> shift);
+        deci_DOUBLE_UWORD q = (xs * v) >> DECI_WORD_BITS;
+        // Only the low half of 'x' is needed here, as the difference is less than (3 * b).
+        r = ((deci_DOUBLE_UWORD) x) - q * b;
+        if (r >= b) {
+            r -= b;
+            ++q;
+            if (r >= b) {
+                r -= b;
+                ++q;
+            }
+        }
+        *wa_end = q;
+    }
+    return r;
+}
+
+DECI_API
+deci_QUAD_UWORD deci_divmod_tword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_QUAD_UWORD b)
+{
+    STATS(stats_call(DECI_STATS_DIVMOD_TWORD, wa_end - wa);)
+
+    const unsigned shift = quad_bit_length(b) - 1;
+    const deci_DOUBLE_UWORD v = (((deci_QUAD_UWORD) 1) << (shift + DECI_WORD_BITS)) / b;
+
+    deci_QUAD_UWORD r = 0;
+    while (wa_end != wa) {
+        --wa_end;
+        const deci_QUAD_UWORD x = r * DECI_BASE + *wa_end;
+        const deci_DOUBLE_UWORD xs = (deci_DOUBLE_UWORD) (x >> shift);
+        deci_DOUBLE_UWORD q = (xs * v) >> DECI_WORD_BITS;
+        r = x - q * b;
+        if (r >= b) {
+            r -= b;
+            ++q;
+            if (r >= b) {
+                r -= b;
+                ++q;
+            }
+        }
+        *wa_end = q;
+    }
+    return r;
+}
+
+// Writes 'x', which must be less than (DECI_BASE^n), into (out ... out + n), 1 <= n <= 3.
+static void quad_to_words(deci_QUAD_UWORD x, deci_UWORD *out, size_t n)
+{
+    deci_DOUBLE_UWORD lo;
+    if (n == 3) {
+        const deci_QUAD_UWORD b2 = DECI_BASE * (deci_QUAD_UWORD) DECI_BASE;
+        out[2] = x / b2;
+        lo = x % b2;
+    } else {
+        lo = x;
+    }
+    out[0] = lo % DECI_BASE;
+    if (n > 1)
+        out[1] = lo / DECI_BASE;
+}
+
+// Divides (wa ... wa_end) by the normalized (wb ... wb_end) of two or three words, writing the
+// quotient into (wa ... wa_end) and the remainder into (r_out ... r_out + (wb_end - wb)).
+static void divmod_short(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *r_out)
+{
+    if (wb_end - wb == 2) {
+        const deci_DOUBLE_UWORD r = deci_divmod_dword(wa, wa_end, combine(wb[1], wb[0]));
+        quad_to_words(r, r_out, 2);
+    } else {
+        const deci_QUAD_UWORD b = combine_to_quad(wb[2], combine(wb[1], wb[0]));
+        quad_to_words(deci_divmod_tword(wa, wa_end, b), r_out, 3);
+    }
+}
+
+DECI_API
+size_t deci_div(
+    deci_UWORD *wa, deci_UWORD *wa_end,
+    deci_UWORD *wb, deci_UWORD *wb_end)
+{
+    STATS(stats_call(DECI_STATS_DIV, (wa_end - wa) + (wb_end - wb));)
+
+    wa_end = deci_normalize(wa, wa_end);
+    wb_end = deci_normalize(wb, wb_end);
+
+    const size_t nwa = wa_end - wa;
+    const size_t nwb = wb_end - wb;
 
     if (nwa < nwb)
         return 0;
@@ -377,6 +1066,12 @@ size_t deci_div(
         return nwa;
     }
 
+    if (nwb <= 3) {
+        deci_UWORD r[3];
+        divmod_short(wa, wa_end, wb, wb_end, r);
+        return nwa;
+    }
+
     const deci_UWORD qhi = deci_divmod_unsafe(wa, wa_end, wb, wb_end);
     const size_t delta = nwa - nwb;
     deci_memmove(wa, wa + nwb, delta);
@@ -384,10 +1079,13 @@ size_t deci_div(
     return delta + 1;
 }
 
+DECI_API
 size_t deci_mod(
     deci_UWORD *wa, deci_UWORD *wa_end,
     deci_UWORD *wb, deci_UWORD *wb_end)
 {
+    STATS(stats_call(DECI_STATS_MOD, (wa_end - wa) + (wb_end - wb));)
+
     wa_end = deci_normalize(wa, wa_end);
     wb_end = deci_normalize(wb, wb_end);
 
@@ -402,12 +1100,400 @@ size_t deci_mod(
         return 1;
     }
 
+    if (nwb <= 3) {
+        divmod_short(wa, wa_end, wb, wb_end, wa);
+        return nwb;
+    }
+
     (void) deci_divmod_unsafe(wa, wa_end, wb, wb_end);
     return nwb;
 }
 
+// Same as 'deci_divmod_uword()', but writes the quotient into (q_out ... q_out + (wa_end - wa))
+// instead of (wa ... wa_end).
+static deci_UWORD divmod_uword_to(
+        deci_UWORD *q_out,
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD b)
+{
+    deci_UWORD carry = 0;
+    size_t i = wa_end - wa;
+    while (i) {
+        --i;
+        const deci_DOUBLE_UWORD x = wa[i] + DECI_BASE * (deci_DOUBLE_UWORD) carry;
+        q_out[i] = x / b;
+        carry = x % b;
+    }
+    return carry;
+}
+
+// Same as 'deci_divmod_unsafe()', but writes the quotient, all ((wr_end - wr) - (wb_end - wb) + 1)
+// words of it, into 'q_out'. The remainder is left in (wr ... wr + (wb_end - wb)).
+static void long_div_to(
+        deci_UWORD *wr, deci_UWORD *wr_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out)
+{
+    const size_t nwb = wb_end - wb;
+
+    const deci_DOUBLE_UWORD b12 = combine(wb_end[-1], wb_end[-2]);
+
+    deci_UWORD *r     = wr_end - nwb;
+    deci_UWORD *r_end = wr_end;
+
+    q_out[r - wr] = long_div_round(r, r_end, wb, wb_end, b12);
+
+    while (r != wr) {
+        --r;
+        q_out[r - wr] = long_div_round(r, r_end, wb, wb_end, b12);
+        --r_end;
+    }
+}
+
+DECI_API
+size_t deci_divrem(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *r_out, size_t *nr)
+{
+    STATS(stats_call(DECI_STATS_DIVREM, (wa_end - wa) + (wb_end - wb));)
+
+    wa_end = deci_normalize(wa, wa_end);
+    wb_end = deci_normalize(wb, wb_end);
+
+    const size_t nwa = wa_end - wa;
+    const size_t nwb = wb_end - wb;
+
+    if (nwa < nwb) {
+        deci_memcpy(r_out, wa, nwa);
+        *nr = nwa;
+        return 0;
+    }
+
+    if (nwb == 1) {
+        *r_out = divmod_uword_to(q_out, wa, wa_end, *wb);
+        *nr = 1;
+        return nwa;
+    }
+
+    if (nwb <= 3) {
+        deci_memcpy(q_out, wa, nwa);
+        divmod_short(q_out, q_out + nwa, wb, wb_end, r_out);
+        *nr = nwb;
+        return nwa;
+    }
+
+    deci_memcpy(r_out, wa, nwa);
+    long_div_to(r_out, r_out + nwa, wb, wb_end, q_out);
+    *nr = nwb;
+    return nwa - nwb + 1;
+}
+
+// ---------------------------------------------------------------------------------------
+// Approximate quotient.
+//
+// Let the dividend 'a' have N words, and the (normalized) divisor 'b' have M words, so that the
+// quotient q = floor(a/b) has K = N - M + 1 words. Drop the T = M - (K + 1) least significant
+// words of both:
+//     a = a' B^T + a_lo,    b = b' B^T + b_lo,    0 <= a_lo, b_lo < B^T,
+// and let q1 = floor(a'/b'), r1 = a' - q1 b'. Then q <= q1 <= q + 1:
+//
+//   * a/b < (a' + 1)/b' = q1 + (r1 + 1)/b' <= q1 + 1, so q <= q1;
+//
+//   * b' has (K + 1) words, so b' >= B^K > q1; then
+//         a/b > a'/(b' + 1) = a'/b' - (a'/b') / (b' + 1) > a'/b' - (q1 + 1)/(b' + 1) >= a'/b' - 1,
+//     so q >= q1 - 1.
+//
+// Computing q1 costs O(K^2) instead of O(K M).
+//
+// To find out if q = q1 - 1, we need to check whether
+//     a - q1 b = r1 B^T + a_lo - q1 b_lo
+// is negative. If (r1 >= q1), it is not, as (q1 b_lo < q1 B^T). Otherwise, which is unlikely unless
+// the numbers are specially crafted, we compute (q1 b_lo) and compare.
+// ---------------------------------------------------------------------------------------
+
+// Checks if (r1 B^t + a_lo) < p, where 'r1' is (wr ... wr + (nw - t)), 'a_lo' is (wa ... wa + t),
+// and 'p' is (wp ... wp + (nw - 1)).
+static bool appr_remainder_is_less(
+        deci_UWORD *wr, deci_UWORD *wa, deci_UWORD *wp,
+        size_t nw, size_t t)
+{
+    if (wr[nw - t - 1])
+        return false;
+    for (size_t i = nw - 1; i;) {
+        --i;
+        const deci_UWORD x = i >= t ? wr[i - t] : wa[i];
+        if (x != wp[i])
+            return x < wp[i];
+    }
+    return false;
+}
+
+static size_t div_appr_impl(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *scratch,
+        bool exact)
+{
+    wa_end = deci_normalize(wa, wa_end);
+    wb_end = deci_normalize(wb, wb_end);
+
+    const size_t nwa = wa_end - wa;
+    const size_t nwb = wb_end - wb;
+
+    if (nwa < nwb)
+        return 0;
+
+    if (nwb == 1) {
+        (void) divmod_uword_to(q_out, wa, wa_end, *wb);
+        return nwa;
+    }
+
+    const size_t nq = nwa - nwb + 1;
+    const size_t t = nwb > nq + 1 ? nwb - (nq + 1) : 0;
+
+    deci_UWORD *r = scratch;
+    deci_memcpy(r, wa + t, nwa - t);
+    long_div_to(r, r + (nwa - t), wb + t, wb_end, q_out);
+
+    if (!exact || !t)
+        return nq;
+
+    // 'r1' has (nq + 1) words, 'q1' has 'nq' words.
+    if (!r[nq] && deci_compare_n(r, q_out, nq, 1, 0, 0)) {
+        deci_UWORD *p = scratch + (nwa - t);
+        deci_zero_out_n(p, nq + t);
+        deci_mul(q_out, q_out + nq, wb, wb + t, p);
+
+        if (appr_remainder_is_less(r, wa, p, nwb, t)) {
+            deci_UWORD *q = q_out;
+            for (; !*q; ++q)
+                *q = DECI_BASE - 1;
+            --*q;
+        }
+    }
+    return nq;
+}
+
+DECI_API
+size_t deci_div_appr(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_DIV_APPR, (wa_end - wa) + (wb_end - wb));)
+
+    return div_appr_impl(wa, wa_end, wb, wb_end, q_out, scratch, /*exact=*/false);
+}
+
+DECI_API
+size_t deci_quotient(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_QUOTIENT, (wa_end - wa) + (wb_end - wb));)
+
+    return div_appr_impl(wa, wa_end, wb, wb_end, q_out, scratch, /*exact=*/true);
+}
+
+// ---------------------------------------------------------------------------------------
+// Exact division.
+//
+// If 'b' is coprime to DECI_BASE and q = a/b is exact, then the least significant word of 'q' is
+//     q_0 = a_0 b_0^{-1} (mod DECI_BASE),
+// where b_0^{-1} is the inverse of b_0 modulo DECI_BASE. Subtracting (q_0 b) from 'a' zeroes out
+// a_0, and the rest of the quotient is (a - q_0 b) / DECI_BASE, so we go on with the next word.
+// Only the quotient words are ever needed, so the subtraction can stop at the most significant
+// of them.
+//
+// A divisor 'b' that is not coprime to DECI_BASE has its least significant words stripped while
+// they are zero (the ones of 'a' are zero then, too), and then both are divided by
+//     g = gcd(b_0, DECI_BASE),
+// a product of powers of 2 and 5, until it is 1. Since 'g' divides DECI_BASE, dividing by it is
+// multiplying by (DECI_BASE / g) and dropping the least significant word, which is zero.
+// ---------------------------------------------------------------------------------------
+
+// Returns gcd(w, DECI_BASE). Assumes (0 < w < DECI_BASE).
+static deci_UWORD gcd_with_base(deci_UWORD w)
+{
+    deci_UWORD g = 1;
+    for (int i = 0; i < DECI_BASE_LOG && w % 2 == 0; ++i) {
+        w /= 2;
+        g *= 2;
+    }
+    for (int i = 0; i < DECI_BASE_LOG && w % 5 == 0; ++i) {
+        w /= 5;
+        g *= 5;
+    }
+    return g;
+}
+
+// Returns the inverse of 'b' modulo DECI_BASE. Assumes 'b' is coprime to DECI_BASE.
+static deci_UWORD inverse_mod_base(deci_UWORD b)
+{
+    static const unsigned char INVERSES_MOD_10[10] = {0, 1, 0, 7, 0, 0, 0, 3, 0, 9};
+
+    // Newton's iteration: if (b x = 1) modulo 10^k, then (b x (2 - b x) = 1) modulo 10^{2k}.
+    deci_DOUBLE_UWORD x = INVERSES_MOD_10[b % 10];
+    for (int k = 1; k < DECI_BASE_LOG; k *= 2) {
+        const deci_DOUBLE_UWORD bx = (b * x) % DECI_BASE;
+        x = (x * (DECI_BASE + 2 - bx)) % DECI_BASE;
+    }
+    return (deci_UWORD) x;
+}
+
+// Divides (wa ... wa + n) by 'g', where 'g' divides both DECI_BASE and the dividend, writing the
+// quotient into (out ... out + n). 'out' may be equal to 'wa'. Assumes (n > 0).
+static void divexact_base_divisor(
+        deci_UWORD *out,
+        deci_UWORD *wa, size_t n,
+        deci_UWORD g)
+{
+    const deci_UWORD m = DECI_BASE / g;
+    deci_UWORD carry = (wa[0] * (deci_DOUBLE_UWORD) m) / DECI_BASE;
+    for (size_t i = 1; i < n; ++i) {
+        const deci_DOUBLE_UWORD x = wa[i] * (deci_DOUBLE_UWORD) m + carry;
+        out[i - 1] = x % DECI_BASE;
+        carry = x / DECI_BASE;
+    }
+    out[n - 1] = carry;
+}
+
+// Divides (wa ... wa + n) by (b g) in place, where 'b' is coprime to DECI_BASE, 'inv' is its
+// inverse modulo DECI_BASE, and 'g' divides DECI_BASE. The division by 'g' is done on the fly as
+// the quotient words come out, which is nearly free, as it is not on the critical path.
+//
+// What is left of the dividend after 'i' steps is (wa + i ... wa + n) minus 'borrow', (borrow < b).
+// With w = (wa[i] - borrow) modulo DECI_BASE, the next quotient word is
+//     q = (w inv) - m DECI_BASE,    where m = floor((w inv) / DECI_BASE),
+// and the next 'borrow' is ((q b - w) / DECI_BASE), plus one if (wa[i] < borrow). If
+// (b inv = 1 + s DECI_BASE), then
+//     (q b - w) / DECI_BASE = w s - m b,
+// which does not depend on 'q', and so the loop-carried chain is one multiplication shorter.
+static inline DECI_FORCE_INLINE
+void divexact_uword_coprime(
+        deci_UWORD *wa, size_t n,
+        deci_UWORD b, deci_UWORD inv,
+        deci_UWORD g)
+{
+    const deci_DOUBLE_UWORD s = (b * (deci_DOUBLE_UWORD) inv) / DECI_BASE;
+    const deci_UWORD mg = DECI_BASE / g;
+
+    deci_UWORD borrow = 0;
+    deci_UWORD carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const bool under = wa[i] < borrow;
+        const deci_UWORD w = wa[i] - borrow + (under ? DECI_BASE : 0);
+        const deci_DOUBLE_UWORD x = w * (deci_DOUBLE_UWORD) inv;
+        const deci_DOUBLE_UWORD m = x / DECI_BASE;
+        const deci_UWORD q = x - m * DECI_BASE;
+        borrow = w * s - m * b + under;
+
+        if (g == 1) {
+            wa[i] = q;
+        } else {
+            // Same as in 'divexact_base_divisor()'.
+            const deci_DOUBLE_UWORD y = q * (deci_DOUBLE_UWORD) mg + carry;
+            if (i)
+                wa[i - 1] = y % DECI_BASE;
+            carry = y / DECI_BASE;
+        }
+    }
+    if (g != 1)
+        wa[n - 1] = carry;
+}
+
+DECI_API
+void deci_divexact_uword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD b)
+{
+    STATS(stats_call(DECI_STATS_DIVEXACT_UWORD, wa_end - wa);)
+
+    const size_t n = wa_end - wa;
+    if (!n)
+        return;
+
+    const deci_UWORD g = gcd_with_base(b);
+    b /= g;
+    // Only if 'b' had more than DECI_BASE_LOG factors of 2 or 5.
+    for (deci_UWORD h; (h = gcd_with_base(b)) != 1;) {
+        divexact_base_divisor(wa, wa, n, h);
+        b /= h;
+    }
+
+    if (b == 1)
+        divexact_base_divisor(wa, wa, n, g);
+    else if (g == 1)
+        divexact_uword_coprime(wa, n, b, inverse_mod_base(b), 1);
+    else
+        divexact_uword_coprime(wa, n, b, inverse_mod_base(b), g);
+}
+
+DECI_API
+size_t deci_divexact(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_DIVEXACT, (wa_end - wa) + (wb_end - wb));)
+
+    wa_end = deci_normalize(wa, wa_end);
+    wb_end = deci_normalize(wb, wb_end);
+
+    if (wa_end - wa < wb_end - wb)
+        return 0;
+
+    const size_t t = deci_skip0(wb, wb_end) - wb;
+    size_t nwa = (wa_end - wa) - t;
+    size_t nwb = (wb_end - wb) - t;
+    wb += t;
+
+    deci_UWORD g = gcd_with_base(*wb);
+    if (g != 1) {
+        divexact_base_divisor(wa, wa + t, nwa, g);
+        divexact_base_divisor(scratch, wb, nwb, g);
+        wb = scratch;
+        while ((g = gcd_with_base(*wb)) != 1) {
+            divexact_base_divisor(wa, wa, nwa, g);
+            divexact_base_divisor(wb, wb, nwb, g);
+        }
+    } else if (t) {
+        deci_memmove(wa, wa + t, nwa);
+    }
+
+    nwa = deci_normalize_n(wa, nwa);
+    nwb = deci_normalize_n(wb, nwb);
+    if (nwa < nwb)
+        return 0;
+
+    const deci_UWORD inv = inverse_mod_base(*wb);
+
+    if (nwb == 1) {
+        divexact_uword_coprime(wa, nwa, *wb, inv, 1);
+        return deci_normalize_n(wa, nwa);
+    }
+
+    const size_t nq = nwa - nwb + 1;
+    for (size_t i = 0; i < nq; ++i) {
+        const deci_UWORD q = (wa[i] * (deci_DOUBLE_UWORD) inv) % DECI_BASE;
+        const size_t n = nq - i < nwb ? nq - i : nwb;
+        (void) deci_sub_scaled_raw(wa + i, wa + nq, q, wb, wb + n);
+        wa[i] = q;
+    }
+    return deci_normalize_n(wa, nq);
+}
+
+DECI_API
 deci_UWORD deci_tobits_round(deci_UWORD *wa, deci_UWORD *wa_end)
 {
+    STATS(stats_call(DECI_STATS_TOBITS_ROUND, wa_end - wa);)
+
     deci_UWORD carry = 0;
 
     while (wa_end != wa) {
@@ -420,8 +1506,11 @@ deci_UWORD deci_tobits_round(deci_UWORD *wa, deci_UWORD *wa_end)
     return carry;
 }
 
+DECI_API
 void deci_tolong(deci_UWORD *wa, deci_UWORD *wa_end, deci_DOUBLE_UWORD *out)
 {
+    STATS(stats_call(DECI_STATS_TOLONG, wa_end - wa);)
+
     const size_t nwa = wa_end - wa;
     if (nwa % 2) {
         --wa_end;
@@ -435,8 +1524,11 @@ void deci_tolong(deci_UWORD *wa, deci_UWORD *wa_end, deci_DOUBLE_UWORD *out)
     }
 }
 
+DECI_API
 deci_DOUBLE_UWORD deci_long_tobits_round(deci_DOUBLE_UWORD *wd, deci_DOUBLE_UWORD *wd_end)
 {
+    STATS(stats_call(DECI_STATS_LONG_TOBITS_ROUND, wd_end - wd);)
+
     deci_DOUBLE_UWORD carry = 0;
 
     while (wd_end != wd) {
@@ -449,8 +1541,11 @@ deci_DOUBLE_UWORD deci_long_tobits_round(deci_DOUBLE_UWORD *wd, deci_DOUBLE_UWOR
     return carry;
 }
 
+DECI_API
 deci_UWORD deci_frombits_round(deci_UWORD *wa, deci_UWORD *wa_end)
 {
+    STATS(stats_call(DECI_STATS_FROMBITS_ROUND, wa_end - wa);)
+
     deci_UWORD carry = 0;
 
     for (; wa != wa_end; ++wa) {
@@ -462,3 +1557,1722 @@ deci_UWORD deci_frombits_round(deci_UWORD *wa, deci_UWORD *wa_end)
 
     return carry;
 }
+
+// The number of bits 'deci_mul_pow2()' multiplies by per pass: with w < 2^DECI_BASE_BITS and the
+// carry c < 2^MUL_POW2_CHUNK, (w 2^MUL_POW2_CHUNK + c) < 2^(MUL_POW2_CHUNK + DECI_BASE_BITS) fits
+// into a double word, and the next carry is again less than 2^MUL_POW2_CHUNK.
+//
+// The number of bits 'deci_divmod_pow2()' divides by per pass: with the remainder r < 2^D,
+// (r DECI_BASE + w) < 2^(D + DECI_BASE_BITS) fits into a quad word. D is a multiple of the word
+// size, so that each pass gives whole words of the remainder.
+enum {
+    MUL_POW2_CHUNK = DECI_DOUBLE_WORD_BITS - DECI_BASE_BITS,
+    DIVMOD_POW2_CHUNK = 3 * DECI_WORD_BITS,
+};
+
+DECI_API
+deci_UWORD deci_mul_pow2(deci_UWORD *wa, deci_UWORD *wa_end, size_t k)
+{
+    STATS(stats_call(DECI_STATS_MUL_POW2, wa_end - wa);)
+
+    const size_t nwa = wa_end - wa;
+    size_t n = deci_normalize_n(wa, nwa);
+    // The word right above (wa ... wa_end); it only gets non-zero once the rest are all in use.
+    deci_DOUBLE_UWORD top = 0;
+
+    while (k && n) {
+        const unsigned c = k < MUL_POW2_CHUNK ? k : (size_t) MUL_POW2_CHUNK;
+        k -= c;
+
+        deci_DOUBLE_UWORD carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const deci_DOUBLE_UWORD x = (((deci_DOUBLE_UWORD) wa[i]) << c) + carry;
+            wa[i] = x % DECI_BASE;
+            carry = x / DECI_BASE;
+        }
+        for (; carry && n != nwa; carry /= DECI_BASE)
+            wa[n++] = carry % DECI_BASE;
+        top = (top << c) + carry;
+    }
+
+    return top;
+}
+
+DECI_API
+size_t deci_divmod_pow2(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem)
+{
+    STATS(stats_call(DECI_STATS_DIVMOD_POW2, wa_end - wa);)
+
+    size_t n = deci_normalize_n(wa, wa_end - wa);
+
+    while (k) {
+        if (!n) {
+            // The rest of the bits shifted out are all zeros.
+            if (rem)
+                deci_zero_out_n(rem, (k / DECI_WORD_BITS) + !!(k % DECI_WORD_BITS));
+            break;
+        }
+
+        const unsigned c = k < DIVMOD_POW2_CHUNK ? k : (size_t) DIVMOD_POW2_CHUNK;
+        k -= c;
+        const deci_QUAD_UWORD mask = (((deci_QUAD_UWORD) 1) << c) - 1;
+
+        deci_QUAD_UWORD r = 0;
+        for (size_t i = n; i--;) {
+            const deci_QUAD_UWORD x = r * DECI_BASE + wa[i];
+            wa[i] = x >> c;
+            r = x & mask;
+        }
+        n = deci_normalize_n(wa, n);
+
+        if (rem) {
+            for (unsigned j = 0; j < c; j += DECI_WORD_BITS) {
+                *rem++ = (deci_UWORD) r;
+                r >>= DECI_WORD_BITS;
+            }
+        }
+    }
+
+    return n;
+}
+
+static const deci_UWORD TENPOWS[] = {
+#define X(I_, V_) V_,
+    DECI_FOR_EACH_TENPOW(X)
+#undef X
+};
+
+// These are 'deci_mul_uword()' and 'deci_divmod_uword()' that are forcibly inlined, so that when
+// 'b' is a compile-time constant, the compiler is able to replace the divisions by multiplications.
+
+static inline DECI_FORCE_INLINE
+deci_UWORD mul_by_const(deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD b)
+{
+    deci_UWORD carry = 0;
+    for (; wa != wa_end; ++wa) {
+        const deci_DOUBLE_UWORD x = *wa * ((deci_DOUBLE_UWORD) b) + carry;
+        *wa = x % DECI_BASE;
+        carry = x / DECI_BASE;
+    }
+    return carry;
+}
+
+static inline DECI_FORCE_INLINE
+deci_UWORD divmod_by_const(deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD b)
+{
+    deci_UWORD carry = 0;
+    while (wa_end != wa) {
+        --wa_end;
+        const deci_DOUBLE_UWORD x = *wa_end + DECI_BASE * (deci_DOUBLE_UWORD) carry;
+        *wa_end = x / b;
+        carry = x % b;
+    }
+    return carry;
+}
+
+// Multiplies (wa ... wa_end) by (10 raised to 'k'), where (k < DECI_BASE_LOG).
+static deci_UWORD mul_tenpow(deci_UWORD *wa, deci_UWORD *wa_end, unsigned k)
+{
+    switch (k) {
+#define X(I_, V_) case I_: return mul_by_const(wa, wa_end, V_);
+    DECI_FOR_EACH_TENPOW(X)
+#undef X
+    }
+    return 0;
+}
+
+// Divides (wa ... wa_end) by (10 raised to 'k'), where (k < DECI_BASE_LOG).
+static deci_UWORD divmod_tenpow(deci_UWORD *wa, deci_UWORD *wa_end, unsigned k)
+{
+    switch (k) {
+#define X(I_, V_) case I_: return divmod_by_const(wa, wa_end, V_);
+    DECI_FOR_EACH_TENPOW(X)
+#undef X
+    }
+    return 0;
+}
+
+DECI_API
+deci_UWORD deci_shl10(deci_UWORD *wa, deci_UWORD *wa_end, size_t k)
+{
+    STATS(stats_call(DECI_STATS_SHL10, wa_end - wa);)
+
+    const size_t nwa = wa_end - wa;
+    const size_t nshift = k / DECI_BASE_LOG;
+    const unsigned r = k % DECI_BASE_LOG;
+
+    // If (nshift >= nwa), then, by assumption, (wa ... wa_end) represents the value of zero.
+    if (nshift >= nwa)
+        return 0;
+
+    const size_t n = deci_normalize_n(wa, nwa - nshift);
+    deci_memmove(wa + nshift, wa, n);
+    deci_zero_out_n(wa, nshift);
+
+    if (!r)
+        return 0;
+
+    deci_UWORD *hi = wa + nshift + n;
+    const deci_UWORD carry = mul_tenpow(wa + nshift, hi, r);
+    if (hi == wa_end)
+        return carry;
+    *hi = carry;
+    return 0;
+}
+
+static size_t shr10_impl(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        size_t k,
+        deci_UWORD *rem,
+        bool round)
+{
+    const size_t nwa = wa_end - wa;
+    const size_t nshift = k / DECI_BASE_LOG;
+    const unsigned r = k % DECI_BASE_LOG;
+
+    if (!k)
+        return nwa;
+
+    if (nshift >= nwa) {
+        // The quotient is zero; it can only be rounded up to one if (10 raised to 'k') is exactly
+        // (DECI_BASE raised to 'nwa'), and the value is greater than half of that.
+        bool up = false;
+        if (round && nshift == nwa && !r && nwa) {
+            const deci_UWORD hw = wa[nwa - 1];
+            up = hw > DECI_BASE / 2 || (hw == DECI_BASE / 2 && !deci_is_zero_n(wa, nwa - 1));
+        }
+        if (rem) {
+            deci_memcpy(rem, wa, nwa);
+            deci_zero_out_n(rem + nwa, nshift + !!r - nwa);
+        }
+        deci_zero_out(wa, wa_end);
+        if (up) {
+            wa[0] = 1;
+            return 1;
+        }
+        return 0;
+    }
+
+    // The remainder is compared against half of the divisor by comparing 'hw', the most significant
+    // word of the shifted-out part, against 'hw_half'; if they are equal, 'sticky' tells whether
+    // any of the less significant shifted-out words are non-zero.
+    deci_UWORD hw = 0;
+    deci_UWORD hw_half = DECI_BASE / 2;
+    bool sticky = false;
+    if (round) {
+        if (r) {
+            sticky = !deci_is_zero_n(wa, nshift);
+        } else {
+            hw = wa[nshift - 1];
+            sticky = !deci_is_zero_n(wa, nshift - 1);
+        }
+    }
+
+    if (rem)
+        deci_memcpy(rem, wa, nshift);
+
+    size_t nq = nwa - nshift;
+    deci_memmove(wa, wa + nshift, nq);
+    deci_zero_out(wa + nq, wa_end);
+
+    if (r) {
+        hw = divmod_tenpow(wa, wa + nq, r);
+        hw_half = TENPOWS[r - 1] * 5;
+        if (rem)
+            rem[nshift] = hw;
+    }
+
+    if (round && (hw > hw_half || (hw == hw_half && (sticky || wa[0] % 2)))) {
+        deci_UWORD one = 1;
+        // If (nshift == 0), the quotient is less than (DECI_BASE raised to 'nq') divided by ten, so
+        // that incrementing it never overflows; otherwise, (wa + nq) is a valid word.
+        if (deci_add(wa, wa + nq, &one, &one + 1))
+            wa[nq++] = 1;
+    }
+
+    return nq;
+}
+
+DECI_API
+size_t deci_shr10(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem)
+{
+    STATS(stats_call(DECI_STATS_SHR10, wa_end - wa);)
+    return shr10_impl(wa, wa_end, k, rem, /*round=*/false);
+}
+
+DECI_API
+size_t deci_shr10_round(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem)
+{
+    STATS(stats_call(DECI_STATS_SHR10_ROUND, wa_end - wa);)
+    return shr10_impl(wa, wa_end, k, rem, /*round=*/true);
+}
+
+// ---------------------------------------------------------------------------------------
+// Integer powers.
+//
+// Both 'deci_pow()' and 'deci_pow2()' go over the bits of the exponent from the most significant
+// one, squaring the result for each bit and multiplying it by the base for each non-zero one, and
+// ping-pong between 'out' and 'scratch'. If the result so far is (x^e), with (2 e <= k), its square
+// takes at most (2 M e <= M k) words for an M-word base; and its product with the base, at most
+// (M (e + 1) <= M k). This is why 'deci_pow_nwords_max()' is enough for both buffers.
+//
+// For 'deci_pow2()', the same holds with the sizes of the powers of two: the square of 2^e takes at
+// most one word more than 2^(2e) does. On the base of 2 passed to 'deci_pow()', these sizes never
+// exceed 'k' words either: the first word alone holds up to 2^(DECI_BASE_BITS - 1), and from
+// there on, each word takes more than 13 bits.
+// ---------------------------------------------------------------------------------------
+
+// Writes the square of (wa ... wa_end) into (out ... out + 2 N), where N = (wa_end - wa). 'out'
+// must not overlap with (wa ... wa_end).
+//
+// Each product of two different words is computed once, and doubled, so this takes about half of
+// the work of 'deci_mul()' on the same operands.
+static void square(deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD *out)
+{
+    const size_t n = wa_end - wa;
+    deci_zero_out_n(out, 2 * n);
+    if (!n)
+        return;
+
+    // The products (wa[i] wa[j]) with (i < j); their sum is less than half of the square.
+    for (size_t i = 0; i + 1 < n; ++i)
+        deci_add_scaled(out + 2 * i + 1, wa[i], wa + i + 1, wa_end);
+
+    // Double them, and add the squares (wa[i] wa[i]) in the same pass.
+    deci_DOUBLE_UWORD carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const deci_DOUBLE_UWORD sq = ((deci_DOUBLE_UWORD) wa[i]) * wa[i];
+        deci_DOUBLE_UWORD x = 2 * (deci_DOUBLE_UWORD) out[2 * i] + sq % DECI_BASE + carry;
+        out[2 * i] = x % DECI_BASE;
+        carry = x / DECI_BASE;
+        x = 2 * (deci_DOUBLE_UWORD) out[2 * i + 1] + sq / DECI_BASE + carry;
+        out[2 * i + 1] = x % DECI_BASE;
+        carry = x / DECI_BASE;
+    }
+}
+
+// Returns the position of the most significant non-zero bit of 'k', which must not be zero.
+static unsigned top_bit(size_t k)
+{
+    unsigned r = 0;
+    while (k >>= 1)
+        ++r;
+    return r;
+}
+
+// Squares (x ... x + nx) into 'y', and returns the size of the square.
+static inline DECI_FORCE_INLINE
+size_t square_into(deci_UWORD *x, size_t nx, deci_UWORD *y)
+{
+    square(x, x + nx, y);
+    return deci_normalize_n(y, 2 * nx);
+}
+
+static size_t pow2_impl(size_t k, deci_UWORD *out, deci_UWORD *scratch)
+{
+    // Take as many of the top bits of 'k' as make a power of two less than DECI_BASE.
+    unsigned shift = 0;
+    while ((k >> shift) >= DECI_BASE_BITS)
+        ++shift;
+
+    deci_UWORD *x = out;
+    deci_UWORD *y = scratch;
+    x[0] = ((deci_UWORD) 1) << (k >> shift);
+    size_t nx = 1;
+
+    while (shift--) {
+        nx = square_into(x, nx, y);
+        SWAP(deci_UWORD *, x, y);
+        if ((k >> shift) & 1) {
+            const deci_UWORD carry = mul_by_const(x, x + nx, 2);
+            if (carry)
+                x[nx++] = carry;
+        }
+    }
+
+    if (x != out)
+        deci_memcpy(out, x, nx);
+    return nx;
+}
+
+DECI_API
+size_t deci_pow2(size_t k, deci_UWORD *out, deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_POW2, deci_pow2_nwords_max(k));)
+
+    return pow2_impl(k, out, scratch);
+}
+
+DECI_API
+size_t deci_pow(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        size_t k,
+        deci_UWORD *out,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_POW, wa_end - wa);)
+
+    const size_t n = deci_normalize_n(wa, wa_end - wa);
+    if (!k) {
+        out[0] = 1;
+        return 1;
+    }
+    if (!n)
+        return 0;
+
+    // A power of ten, 10^t, is raised to 10^(t k): a shift by whole words, and a word from
+    // 'TENPOWS'.
+    if (deci_is_zero_n(wa, n - 1)) {
+        for (unsigned r = 0; r < DECI_BASE_LOG; ++r) {
+            if (wa[n - 1] != TENPOWS[r])
+                continue;
+            const size_t t = (n - 1) * DECI_BASE_LOG + r;
+            const size_t nshift = (t * k) / DECI_BASE_LOG;
+            deci_zero_out_n(out, nshift);
+            out[nshift] = TENPOWS[(t * k) % DECI_BASE_LOG];
+            return nshift + 1;
+        }
+    }
+
+    if (n == 1 && wa[0] == 2)
+        return pow2_impl(k, out, scratch);
+
+    deci_UWORD *x = out;
+    deci_UWORD *y = scratch;
+    deci_memcpy(x, wa, n);
+    size_t nx = n;
+
+    for (unsigned bit = top_bit(k); bit--;) {
+        nx = square_into(x, nx, y);
+        SWAP(deci_UWORD *, x, y);
+        if (!((k >> bit) & 1))
+            continue;
+        if (n == 1) {
+            const deci_UWORD carry = deci_mul_uword(x, x + nx, wa[0]);
+            if (carry)
+                x[nx++] = carry;
+        } else {
+            deci_zero_out_n(y, nx + n);
+            deci_mul(x, x + nx, wa, wa + n, y);
+            nx = deci_normalize_n(y, nx + n);
+            SWAP(deci_UWORD *, x, y);
+        }
+    }
+
+    if (x != out)
+        deci_memcpy(out, x, nx);
+    return nx;
+}
+
+// Computes the integer square root of 'x', writing the remainder into '*rem'.
+static deci_QUAD_UWORD isqrt_quad(deci_QUAD_UWORD x, deci_QUAD_UWORD *rem)
+{
+    deci_QUAD_UWORD s = 0;
+    deci_QUAD_UWORD bit = ((deci_QUAD_UWORD) 1) << (2 * DECI_DOUBLE_WORD_BITS - 2);
+    while (bit > x)
+        bit >>= 2;
+    for (; bit; bit >>= 2) {
+        if (x >= s + bit) {
+            x -= s + bit;
+            s = (s >> 1) + bit;
+        } else {
+            s >>= 1;
+        }
+    }
+    *rem = x;
+    return s;
+}
+
+// ---------------------------------------------------------------------------------------
+// The square root is computed by the "long-hand" algorithm, one word of the root per round:
+// if 's' is the root found so far and 'r' is the remainder, a round brings down the next two
+// words of the radicand, r' = r * DECI_BASE^2 + w, and finds the maximal 'q' such that
+//     T(q) = (2 * s * DECI_BASE + q) * q
+// is not greater than r'. The new root is (s * DECI_BASE + q), and the new remainder is
+// (r' - T(q)).
+//
+// We keep D = 2 * s in 'out', with a free word below it; putting 'q' into that word gives the
+// span Y(q) = (2 * s * DECI_BASE + q), so T(q) can be subtracted from the remainder with a single
+// 'deci_sub_scaled_raw()'. 'q' is estimated as for long division, by dividing the top words of r'
+// by the top words of D; as the estimate ignores the (q * q) term, it may be too large, in which
+// case we decrement it while adding back
+//     T(q) - T(q - 1) = Y(q) + (q - 1).
+//
+// The estimate is only good if 's' is large enough; so the first round takes the 3 or 4 most
+// significant words (depending on the parity of the length) at once, which gives s >= DECI_BASE.
+// ---------------------------------------------------------------------------------------
+
+DECI_API
+size_t deci_sqrtrem(deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_SQRTREM, wa_end - wa);)
+
+    wa_end = deci_normalize(wa, wa_end);
+    const size_t nwa = wa_end - wa;
+    if (!nwa)
+        return 0;
+
+    const size_t nroot = (nwa / 2) + (nwa % 2);
+    const size_t nfirst = nwa <= 4 ? nwa : (4 - nwa % 2);
+
+    deci_UWORD *r = wa_end - nfirst;
+
+    deci_QUAD_UWORD x = 0;
+    for (size_t i = nfirst; i; --i)
+        x = x * DECI_BASE + r[i - 1];
+
+    deci_QUAD_UWORD rem;
+    deci_QUAD_UWORD d = 2 * isqrt_quad(x, &rem);
+
+    for (size_t i = 0; i < nfirst; ++i) {
+        r[i] = rem % DECI_BASE;
+        rem /= DECI_BASE;
+    }
+
+    // 'd' has at most (nfirst / 2 + nfirst % 2 + 1) words; its least significant word goes to
+    // 'y', so that its most significant word is 'out[nroot]'.
+    deci_UWORD *y = out + nroot - ((nfirst / 2) + (nfirst % 2));
+    for (deci_UWORD *p = y; p != out + nroot + 1; ++p) {
+        *p = d % DECI_BASE;
+        d /= DECI_BASE;
+    }
+
+    while (r != wa) {
+        r -= 2;
+        --y;
+
+        deci_UWORD *y_end = out + nroot + !!out[nroot];
+        const size_t ny = y_end - y;
+
+        // r' is less than (DECI_BASE raised to (ny + 1)), and there are always at least that many
+        // words behind 'r'.
+        deci_UWORD *r_end = r + ny + 1;
+
+        deci_UWORD q = estimate_quotient(
+            /*r1=*/r_end[-1],
+            /*r23=*/combine(r_end[-2], r_end[-3]),
+            /*b12=*/combine(y_end[-1], y_end[-2]));
+        *y = q;
+
+        if (deci_sub_scaled_raw(r, r_end, q, y, y_end)) {
+            bool carry;
+            do {
+                carry = deci_add(r, r_end, y, y_end);
+                --q;
+                *y = q;
+                deci_UWORD w = q;
+                carry |= deci_add(r, r_end, &w, &w + 1);
+            } while (!carry);
+        }
+
+        deci_UWORD w = q;
+        (void) deci_add(y, out + nroot + 1, &w, &w + 1);
+    }
+
+    (void) deci_divmod_uword(out, out + nroot + 1, 2);
+    return nroot;
+}
+
+// ---------------------------------------------------------------------------------------
+// For more info on Lehmer's GCD algorithm, see Knuth section 4.5.2 algorithm L.
+//
+// We run Euclid's algorithm on the two most significant words of 'a' and 'b' (taken at the
+// same position), accumulating the 2x2 matrix of cofactors, for as long as the quotients are
+// provably the same as for the full numbers and the cofactors fit into a word; then the matrix
+// is applied to 'a' and 'b' in a single linear pass each. Only if no quotient could be
+// determined this way do we perform a long division step.
+// ---------------------------------------------------------------------------------------
+
+static inline DECI_FORCE_INLINE
+deci_DOUBLE_UWORD abs_dsword(deci_DOUBLE_SWORD x)
+{
+    return x < 0 ? -(deci_DOUBLE_UWORD) x : (deci_DOUBLE_UWORD) x;
+}
+
+// Finds the Lehmer matrix {m[0], m[1]; m[2], m[3]} for the leading parts 'ah' and 'bh',
+// (ah >= bh). The absolute values of all its elements are less than 'DECI_BASE'.
+//
+// Returns false if not a single quotient could be determined, that is, if (m[1] == 0).
+static bool lehmer_matrix(deci_DOUBLE_SWORD ah, deci_DOUBLE_SWORD bh, deci_DOUBLE_SWORD *m)
+{
+    deci_DOUBLE_SWORD A = 1, B = 0, C = 0, D = 1;
+    for (;;) {
+        if (bh + C <= 0 || bh + D <= 0)
+            break;
+        const deci_DOUBLE_SWORD q = (ah + A) / (bh + C);
+        if (q != (ah + B) / (bh + D))
+            break;
+
+        // Consecutive cofactors have opposite signs, so |A - q*C| = |A| + q*|C|; same for B, D.
+        const deci_DOUBLE_UWORD max_cofactor = DECI_BASE - 1;
+        if (C && (deci_DOUBLE_UWORD) q > (max_cofactor - abs_dsword(A)) / abs_dsword(C))
+            break;
+        if ((deci_DOUBLE_UWORD) q > (max_cofactor - abs_dsword(B)) / abs_dsword(D))
+            break;
+
+        deci_DOUBLE_SWORD t;
+        t = A - q * C; A = C; C = t;
+        t = B - q * D; B = D; D = t;
+        t = ah - q * bh; ah = bh; bh = t;
+    }
+    m[0] = A;
+    m[1] = B;
+    m[2] = C;
+    m[3] = D;
+    return B != 0;
+}
+
+// Computes ((wx ... wx + n) times 'x') minus ((wy ... wy + n) times 'y'), writing the result into
+// (out ... out + n).
+//
+// Assumes that the result is non-negative and fits into 'n' words. 'out' may be equal to 'wx' or
+// 'wy'.
+static void lincomb_sub(
+        deci_UWORD *out,
+        deci_UWORD *wx, deci_UWORD x,
+        deci_UWORD *wy, deci_UWORD y,
+        size_t n)
+{
+    deci_UWORD x_carry = 0;
+    deci_UWORD y_carry = 0;
+    BORROW borrow = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const deci_DOUBLE_UWORD px = wx[i] * ((deci_DOUBLE_UWORD) x) + x_carry;
+        const deci_DOUBLE_UWORD py = wy[i] * ((deci_DOUBLE_UWORD) y) + y_carry;
+        x_carry = px / DECI_BASE;
+        y_carry = py / DECI_BASE;
+
+        deci_UWORD w = px % DECI_BASE;
+        borrow = sbb(&w, py % DECI_BASE, borrow);
+        out[i] = w;
+    }
+}
+
+// Computes ((wx ... wx + n) times 'x') plus ((wy ... wy + n) times 'y'), writing the result into
+// (out ... out + n + 1).
+//
+// Assumes that the result fits into (n + 1) words. 'out' may be equal to 'wx' or 'wy'.
+static void lincomb_add(
+        deci_UWORD *out,
+        deci_UWORD *wx, deci_UWORD x,
+        deci_UWORD *wy, deci_UWORD y,
+        size_t n)
+{
+    deci_UWORD x_carry = 0;
+    deci_UWORD y_carry = 0;
+    CARRY carry = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const deci_DOUBLE_UWORD px = wx[i] * ((deci_DOUBLE_UWORD) x) + x_carry;
+        const deci_DOUBLE_UWORD py = wy[i] * ((deci_DOUBLE_UWORD) y) + y_carry;
+        x_carry = px / DECI_BASE;
+        y_carry = py / DECI_BASE;
+
+        deci_UWORD w = px % DECI_BASE;
+        carry = adc(&w, py % DECI_BASE, carry);
+        out[i] = w;
+    }
+    out[n] = x_carry + y_carry + CARRY_TO_1BIT(carry);
+}
+
+// Computes (p * a + q * b), where 'p' and 'q' are elements of a row of a Lehmer matrix.
+static void lehmer_apply(
+        deci_UWORD *out,
+        deci_UWORD *wa, deci_UWORD *wb, size_t n,
+        deci_DOUBLE_SWORD p, deci_DOUBLE_SWORD q)
+{
+    if (p > 0 || (p == 0 && q <= 0))
+        lincomb_sub(out, wa, p, wb, abs_dsword(q), n);
+    else
+        lincomb_sub(out, wb, q, wa, abs_dsword(p), n);
+}
+
+// Adds ((wq ... wq + nq) times (wz ... wz + nz)) to (wx ... implied_wx_end).
+static void add_mul(
+        deci_UWORD *wx,
+        deci_UWORD *wq, size_t nq,
+        deci_UWORD *wz, size_t nz)
+{
+    for (size_t i = 0; i < nq; ++i)
+        if (wq[i])
+            deci_add_scaled(wx + i, wq[i], wz, wz + nz);
+}
+
+// The cofactor of the original 'a' is tracked, for both the current 'a' and the current 'b', as
+// an absolute value and a sign; if 'sa' is NULL, cofactors are not tracked. 'sa', 'sb' and 'st'
+// must each have capacity of 'ns_max' words.
+//
+// The result is written into (wa ... wa + N), where N is the return value; the cofactor, if
+// tracked, is written into 'sa'.
+static size_t gcd_impl(
+        deci_UWORD *wa, size_t na,
+        deci_UWORD *wb, size_t nb,
+        deci_UWORD *wt,
+        deci_UWORD *sa, deci_UWORD *sb, deci_UWORD *st, size_t ns_max,
+        size_t *out_nsa, bool *out_neg)
+{
+    deci_UWORD *a = wa;
+    deci_UWORD *b = wb;
+    deci_UWORD *t = wt;
+    deci_UWORD *const ws = sa;
+    na = deci_normalize_n(a, na);
+    nb = deci_normalize_n(b, nb);
+
+    size_t nsa = 0;
+    size_t nsb = 0;
+    bool neg_a = false;
+    bool neg_b = false;
+    if (sa) {
+        deci_zero_out_n(sa, ns_max);
+        deci_zero_out_n(sb, ns_max);
+        deci_zero_out_n(st, ns_max);
+        sa[0] = 1;
+        nsa = 1;
+    }
+
+    for (;;) {
+        if (na < nb || (na == nb && deci_compare_n(a, b, na, 1, 0, 0))) {
+            SWAP(deci_UWORD *, a, b);
+            SWAP(size_t, na, nb);
+            SWAP(deci_UWORD *, sa, sb);
+            SWAP(size_t, nsa, nsb);
+            SWAP(bool, neg_a, neg_b);
+        }
+
+        if (!nb)
+            break;
+
+        deci_DOUBLE_SWORD m[4];
+
+        if (na == nb && na >= 2 && na >= DECI_GCD_LEHMER_THRESHOLD && lehmer_matrix(
+                combine(a[na - 1], a[na - 2]),
+                combine(b[na - 1], b[na - 2]),
+                m))
+        {
+            lehmer_apply(t, a, b, na, m[0], m[1]);
+            lehmer_apply(b, a, b, na, m[2], m[3]);
+            SWAP(deci_UWORD *, a, t);
+            nb = deci_normalize_n(b, na);
+            na = deci_normalize_n(a, na);
+
+            if (sa) {
+                const bool neg_t = (m[0] && nsa) ? ((m[0] < 0) != neg_a) : ((m[1] < 0) != neg_b);
+                neg_b = (m[2] && nsa) ? ((m[2] < 0) != neg_a) : ((m[3] < 0) != neg_b);
+                neg_a = neg_t;
+
+                const size_t n = nsa > nsb ? nsa : nsb;
+                lincomb_add(st, sa, abs_dsword(m[0]), sb, abs_dsword(m[1]), n);
+                lincomb_add(sb, sa, abs_dsword(m[2]), sb, abs_dsword(m[3]), n);
+                SWAP(deci_UWORD *, sa, st);
+                nsa = deci_normalize_n(sa, n + 1);
+                nsb = deci_normalize_n(sb, n + 1);
+            }
+
+        } else if (nb == 1) {
+            const deci_UWORD r = deci_divmod_uword(a, a + na, b[0]);
+            if (sa) {
+                if (!nsa)
+                    neg_a = !neg_b;
+                add_mul(sa, a, na, sb, nsb);
+                nsa = deci_normalize_n(sa, ns_max);
+            }
+            a[0] = r;
+            na = !!r;
+
+        } else {
+            const deci_UWORD qhi = deci_divmod_unsafe(a, a + na, b, b + nb);
+            if (sa) {
+                if (!nsa)
+                    neg_a = !neg_b;
+                add_mul(sa, a + nb, na - nb, sb, nsb);
+                if (qhi)
+                    deci_add_scaled(sa + (na - nb), qhi, sb, sb + nsb);
+                nsa = deci_normalize_n(sa, ns_max);
+            }
+            na = deci_normalize_n(a, nb);
+        }
+    }
+
+    if (a != wa)
+        deci_memcpy(wa, a, na);
+    if (sa) {
+        if (sa != ws)
+            deci_memcpy(ws, sa, nsa);
+        *out_nsa = nsa;
+        *out_neg = nsa && neg_a;
+    }
+    return na;
+}
+
+DECI_API
+size_t deci_gcd(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_GCD, (wa_end - wa) + (wb_end - wb));)
+
+    return gcd_impl(
+        wa, wa_end - wa,
+        wb, wb_end - wb,
+        scratch,
+        NULL, NULL, NULL, 0,
+        NULL, NULL);
+}
+
+DECI_API
+size_t deci_gcdext(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *ws, size_t *nws, bool *s_negative,
+        deci_UWORD *scratch)
+{
+    STATS(stats_call(DECI_STATS_GCDEXT, (wa_end - wa) + (wb_end - wb));)
+
+    const size_t nwa = wa_end - wa;
+    const size_t ns_max = (wb_end - wb) + 1;
+    return gcd_impl(
+        wa, nwa,
+        wb, wb_end - wb,
+        scratch,
+        ws, scratch + nwa, scratch + nwa + ns_max, ns_max,
+        nws, s_negative);
+}
+
+// ---------------------------------------------------------------------------------------
+// Residues modulo several words.
+//
+// 'deci_mod_uword_multi()' keeps, for each divisor 'p', a residue 'r' that is only reduced to
+// below (2 p + DECI_BASE), and advances it by one word 'w' as
+//     r := (r c mod' p) + w,    c = DECI_BASE mod p,
+// where the modular product is Shoup's: with c' = floor(c 2^W / p), W being 'DECI_WORD_BITS',
+// and q = floor(r c' / 2^W), the value (r c - q p) is in [0; 2 p) for any r < 2^W, so it can be
+// computed modulo 2^W. The loop over the divisors then has no divisions and no branches, and the
+// divisors are independent of each other, so it runs at several divisors per cycle, and can be
+// vectorized by the compiler (GCC does so at -O3).
+//
+// 'deci_crt()' is Garner's algorithm: it finds the mixed-radix digits 'v_j' of the result, with
+//     x = v_0 + p_0 (v_1 + p_1 (v_2 + ... + p_{k-2} v_{k-1})),    0 <= v_j < p_j,
+// in O(k^2) word operations, and then evaluates the above from the innermost parentheses out.
+// ---------------------------------------------------------------------------------------
+
+enum {
+    MOD_MULTI_BLOCK = 32,
+    // The divisors of a block are padded with ones to a multiple of this, so that the inner loop
+    // has a trip count the compiler can vectorize without a scalar tail.
+    MOD_MULTI_LANES = 8,
+};
+
+static void mod_uword_multi_block(
+        const deci_UWORD *wa, const deci_UWORD *wa_end,
+        const deci_UWORD *divisors, size_t k,
+        deci_UWORD *out)
+{
+    deci_UWORD p[MOD_MULTI_BLOCK];
+    deci_UWORD c[MOD_MULTI_BLOCK];
+    deci_UWORD c_shoup[MOD_MULTI_BLOCK];
+    deci_UWORD r[MOD_MULTI_BLOCK];
+    const size_t nlanes = (k + MOD_MULTI_LANES - 1) / MOD_MULTI_LANES * MOD_MULTI_LANES;
+    for (size_t i = 0; i < nlanes; ++i) {
+        p[i] = i < k ? divisors[i] : 1;
+        c[i] = DECI_BASE % p[i];
+        c_shoup[i] = (((deci_DOUBLE_UWORD) c[i]) << DECI_WORD_BITS) / p[i];
+        r[i] = 0;
+    }
+
+    while (wa_end != wa) {
+        const deci_UWORD w = *--wa_end;
+        for (size_t g = 0; g < nlanes; g += MOD_MULTI_LANES) {
+            for (size_t i = g; i < g + MOD_MULTI_LANES; ++i) {
+                const deci_UWORD q = (r[i] * (deci_DOUBLE_UWORD) c_shoup[i]) >> DECI_WORD_BITS;
+                r[i] = (deci_UWORD) (r[i] * c[i] - q * p[i] + w);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < k; ++i)
+        out[i] = r[i] % p[i];
+}
+
+DECI_API
+void deci_mod_uword_multi(
+        const deci_UWORD *wa, const deci_UWORD *wa_end,
+        const deci_UWORD *divisors, size_t k,
+        deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_MOD_UWORD_MULTI, (wa_end - wa) + k);)
+
+    for (size_t i = 0; i < k; i += MOD_MULTI_BLOCK) {
+        const size_t n = k - i < MOD_MULTI_BLOCK ? k - i : (size_t) MOD_MULTI_BLOCK;
+        mod_uword_multi_block(wa, wa_end, divisors + i, n, out + i);
+    }
+}
+
+// Returns the inverse of 'a' modulo 'm'. Assumes (m > 0) and that 'a' is coprime to 'm'.
+static deci_UWORD inverse_mod(deci_UWORD a, deci_UWORD m)
+{
+    // The extended Euclidean algorithm, keeping only the coefficients of 'a'. Their signs
+    // alternate, so only their absolute values are stored, along with the sign of 's1'.
+    deci_UWORD r0 = m, r1 = a % m;
+    deci_UWORD s0 = 0, s1 = 1;
+    bool s1_negative = false;
+    while (r1) {
+        const deci_UWORD q = r0 / r1;
+        const deci_UWORD r2 = r0 - q * r1;
+        const deci_UWORD s2 = s0 + q * s1;
+        r0 = r1;
+        r1 = r2;
+        s0 = s1;
+        s1 = s2;
+        s1_negative = !s1_negative;
+    }
+    // Now (r0 == 1), and 's0' has the opposite sign to that of 's1'.
+    return s1_negative ? s0 : m - s0;
+}
+
+DECI_API
+size_t deci_crt(
+        const deci_UWORD *residues,
+        const deci_UWORD *moduli, size_t k,
+        deci_UWORD *out)
+{
+    STATS(stats_call(DECI_STATS_CRT, k);)
+
+    // The digit 'v_j' is stored into 'out[k - 1 - j]', so that, going from the innermost
+    // parentheses out, the partial result occupies (out ... out + (k - 1 - j)), and the next digit
+    // to add is the word just above it.
+    for (size_t j = 0; j < k; ++j) {
+        const deci_UWORD p = moduli[j];
+        deci_DOUBLE_UWORD t = residues[j];
+        for (size_t i = 0; i < j; ++i) {
+            const deci_UWORD v = out[k - 1 - i] % p;
+            t = ((t + p - v) * inverse_mod(moduli[i], p)) % p;
+        }
+        out[k - 1 - j] = t;
+    }
+
+    if (!k)
+        return 0;
+    for (size_t j = k - 1; j-- > 0;) {
+        const size_t n = k - 1 - j;
+        out[n] = deci_mul_uword_chunk(out, out + n, moduli[j], out[n]);
+    }
+    return deci_normalize_n(out, k);
+}
+
+// ---------------------------------------------------------------------------------------
+// Packed format.
+//
+// Words are packed in groups of four, as four words take a whole number of bytes: (4 * 30 / 8 = 15)
+// or (4 * 14 / 8 = 7). A group is assembled in two 'deci_DOUBLE_UWORD' halves, the low one holding
+// the first two words and the low bits of the third, and stored with constant shifts and no
+// carried dependencies, which compilers turn into a pair of wide stores (and the same for loads).
+// This keeps the format independent of the byte order, and the speed close to that of 'memcpy()'.
+// ---------------------------------------------------------------------------------------
+
+enum {
+    PACK_GROUP_WORDS = 4,
+    PACK_GROUP_BYTES = PACK_GROUP_WORDS * DECI_PACKED_BITS / 8,
+    // The number of bits of the third word that go into the low half.
+    PACK_SPLIT_BITS = DECI_DOUBLE_WORD_BITS - 2 * DECI_PACKED_BITS,
+};
+
+static const deci_UWORD PACK_MASK = ((deci_UWORD) 1 << DECI_PACKED_BITS) - 1;
+
+static inline DECI_FORCE_INLINE
+deci_DOUBLE_UWORD pack_group_lo(const deci_UWORD *w)
+{
+    return ((deci_DOUBLE_UWORD) w[0]) |
+           ((deci_DOUBLE_UWORD) w[1] << DECI_PACKED_BITS) |
+           ((deci_DOUBLE_UWORD) w[2] << (2 * DECI_PACKED_BITS));
+}
+
+static inline DECI_FORCE_INLINE
+deci_DOUBLE_UWORD pack_group_hi(const deci_UWORD *w)
+{
+    return ((deci_DOUBLE_UWORD) w[2] >> PACK_SPLIT_BITS) |
+           ((deci_DOUBLE_UWORD) w[3] << (DECI_PACKED_BITS - PACK_SPLIT_BITS));
+}
+
+// Returns the number of words in the group that are not less than DECI_BASE.
+static inline DECI_FORCE_INLINE
+unsigned unpack_group(deci_DOUBLE_UWORD lo, deci_DOUBLE_UWORD hi, deci_UWORD *w)
+{
+    w[0] = lo & PACK_MASK;
+    w[1] = (lo >> DECI_PACKED_BITS) & PACK_MASK;
+    w[2] = ((lo >> (2 * DECI_PACKED_BITS)) | (hi << PACK_SPLIT_BITS)) & PACK_MASK;
+    w[3] = (hi >> (DECI_PACKED_BITS - PACK_SPLIT_BITS)) & PACK_MASK;
+    return (w[0] >= DECI_BASE) + (w[1] >= DECI_BASE) + (w[2] >= DECI_BASE) + (w[3] >= DECI_BASE);
+}
+
+// The following are spelled out byte by byte so that compilers merge them into single stores and
+// loads.
+
+static inline DECI_FORCE_INLINE
+void store_dword(unsigned char *out, deci_DOUBLE_UWORD x)
+{
+    out[0] = (unsigned char) x;
+    out[1] = (unsigned char) (x >> 8);
+    out[2] = (unsigned char) (x >> 16);
+    out[3] = (unsigned char) (x >> 24);
+#if DECI_WE_ARE_64_BIT
+    out[4] = (unsigned char) (x >> 32);
+    out[5] = (unsigned char) (x >> 40);
+    out[6] = (unsigned char) (x >> 48);
+    out[7] = (unsigned char) (x >> 56);
+#endif
+}
+
+static inline DECI_FORCE_INLINE
+deci_DOUBLE_UWORD load_dword(const unsigned char *in)
+{
+    return ((deci_DOUBLE_UWORD) in[0]) |
+           ((deci_DOUBLE_UWORD) in[1] << 8) |
+           ((deci_DOUBLE_UWORD) in[2] << 16) |
+#if DECI_WE_ARE_64_BIT
+           ((deci_DOUBLE_UWORD) in[3] << 24) |
+           ((deci_DOUBLE_UWORD) in[4] << 32) |
+           ((deci_DOUBLE_UWORD) in[5] << 40) |
+           ((deci_DOUBLE_UWORD) in[6] << 48) |
+           ((deci_DOUBLE_UWORD) in[7] << 56);
+#else
+           ((deci_DOUBLE_UWORD) in[3] << 24);
+#endif
+}
+
+// A group takes one byte less than two 'deci_DOUBLE_UWORD's, so storing or loading the high half
+// whole goes one byte past the group. The store writes a zero there, which the next group then
+// overwrites; the load leaves it in the bits that 'unpack_group()' ignores. The last group is
+// stored and loaded byte by byte instead.
+
+static inline DECI_FORCE_INLINE
+void store_bytes(unsigned char *out, deci_DOUBLE_UWORD lo, deci_DOUBLE_UWORD hi, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const size_t j = i % sizeof(deci_DOUBLE_UWORD);
+        out[i] = (unsigned char) ((i == j ? lo : hi) >> (8 * j));
+    }
+}
+
+static inline DECI_FORCE_INLINE
+void load_bytes(const unsigned char *in, size_t n, deci_DOUBLE_UWORD *lo, deci_DOUBLE_UWORD *hi)
+{
+    *lo = 0;
+    *hi = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t j = i % sizeof(deci_DOUBLE_UWORD);
+        if (i == j)
+            *lo |= (deci_DOUBLE_UWORD) in[i] << (8 * j);
+        else
+            *hi |= (deci_DOUBLE_UWORD) in[i] << (8 * j);
+    }
+}
+
+// Returns the number of bytes in the packed format of 'n' words, not counting the length.
+static size_t packed_body_size(size_t n)
+{
+    return (n / PACK_GROUP_WORDS) * PACK_GROUP_BYTES +
+           ((n % PACK_GROUP_WORDS) * DECI_PACKED_BITS + 7) / 8;
+}
+
+DECI_API
+size_t deci_pack(deci_UWORD *wa, deci_UWORD *wa_end, unsigned char *out)
+{
+    STATS(stats_call(DECI_STATS_PACK, wa_end - wa);)
+
+    wa_end = deci_normalize(wa, wa_end);
+    const size_t n = wa_end - wa;
+
+    unsigned char *p = out;
+    for (size_t x = n; ; x >>= 7) {
+        if (x < 0x80) {
+            *p++ = x;
+            break;
+        }
+        *p++ = 0x80 | (x & 0x7F);
+    }
+
+    // The last group, whole or not, is stored without going past its end.
+    const size_t ngroups = n / PACK_GROUP_WORDS;
+    const size_t nfast = ngroups - (ngroups && n % PACK_GROUP_WORDS == 0);
+    for (size_t i = 0; i < nfast; ++i) {
+        store_dword(p, pack_group_lo(wa));
+        store_dword(p + sizeof(deci_DOUBLE_UWORD), pack_group_hi(wa));
+        wa += PACK_GROUP_WORDS;
+        p += PACK_GROUP_BYTES;
+    }
+
+    const size_t nrest = n - nfast * PACK_GROUP_WORDS;
+    if (nrest) {
+        deci_UWORD last[PACK_GROUP_WORDS] = {0};
+        deci_memcpy(last, wa, nrest);
+        const size_t nbytes = packed_body_size(nrest);
+        store_bytes(p, pack_group_lo(last), pack_group_hi(last), nbytes);
+        p += nbytes;
+    }
+
+    return p - out;
+}
+
+// Decodes the length; returns the number of bytes it takes, or 0 if it is not valid.
+static size_t unpack_length(const unsigned char *in, size_t nin, size_t *n)
+{
+    size_t x = 0;
+    for (size_t i = 0; i < nin; ++i) {
+        const size_t shift = 7 * i;
+        const size_t digit = in[i] & 0x7F;
+        if (shift >= sizeof(size_t) * 8 || (digit << shift) >> shift != digit)
+            return 0;
+        x |= digit << shift;
+        if (!(in[i] & 0x80)) {
+            // The length must be minimal: a zero last byte is only allowed on its own.
+            if (i && !digit)
+                return 0;
+            *n = x;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+DECI_API
+size_t deci_unpacked_nwords(const unsigned char *in, size_t nin)
+{
+    size_t n;
+    const size_t nhead = unpack_length(in, nin, &n);
+    if (!nhead || n > SIZE_MAX / DECI_PACKED_BITS || packed_body_size(n) > nin - nhead)
+        return -1;
+    return n;
+}
+
+DECI_API
+size_t deci_unpack(const unsigned char *in, size_t nin, deci_UWORD *out)
+{
+    const size_t n = deci_unpacked_nwords(in, nin);
+    if (n == (size_t) -1)
+        return 0;
+
+    STATS(stats_call(DECI_STATS_UNPACK, n);)
+
+    const unsigned char *p = in;
+    while (*p++ & 0x80) {
+    }
+
+    unsigned bad = 0;
+    const size_t ngroups = n / PACK_GROUP_WORDS;
+    const size_t nfast = ngroups - (ngroups && n % PACK_GROUP_WORDS == 0);
+    for (size_t i = 0; i < nfast; ++i) {
+        bad += unpack_group(load_dword(p), load_dword(p + sizeof(deci_DOUBLE_UWORD)), out);
+        out += PACK_GROUP_WORDS;
+        p += PACK_GROUP_BYTES;
+    }
+
+    const size_t nrest = n - nfast * PACK_GROUP_WORDS;
+    if (nrest) {
+        deci_UWORD last[PACK_GROUP_WORDS];
+        const size_t nbytes = packed_body_size(nrest);
+        deci_DOUBLE_UWORD lo, hi;
+        load_bytes(p, nbytes, &lo, &hi);
+        bad += unpack_group(lo, hi, last);
+        // The unused bits of the last byte are where the missing words would be.
+        for (size_t i = nrest; i < PACK_GROUP_WORDS; ++i)
+            bad += last[i] != 0;
+        deci_memcpy(out, last, nrest);
+        out += nrest;
+        p += nbytes;
+    }
+
+    if (bad || (n && !out[-1]))
+        return 0;
+    return p - in;
+}
+
+// ---------------------------------------------------------------------------------------
+// Conversion from and to 'double'.
+//
+// A finite double is (m 2^e), with an integer m < 2^53. Once the trailing zero bits of 'm' are
+// moved into 'e', it is exactly either the integer (m 2^e), or (m 5^(-e)) / 10^(-e), where the
+// fraction cannot be reduced, 'm' being odd.
+//
+// The other way round, let the span 'a' have D > 19 digits, and let 'h' be the top 19 of them, so
+// that 2^59 < 10^18 <= h and
+//     h 10^d <= a < (h + 1) 10^d,  d = D - 19.
+// We multiply 'h' by 10^d with 64-bit mantissas, truncating each product; 10^d is itself the
+// product of at most 9 of the numbers 10^(2^k), each truncated to 64 bits (those up to 10^16 are
+// exact). All the errors go the same way and add up to less than
+//     2 * 9 / 2^63 + 1 / h < 2^-58
+// relative to 'a'; so, for the result (M 2^E) with 2^63 <= M < 2^64,
+//     M 2^E <= a < (M + 64) 2^E.
+// Rounding to 53 bits drops the 11 low bits of 'M'; that can only go wrong if there is a midpoint
+// between two doubles in the interval, and only then is the span converted to binary whole.
+// ---------------------------------------------------------------------------------------
+
+enum {
+    // The number of digits of (2^1024 - 1): anything longer overflows.
+    DOUBLE_DIGITS_MAX = 309,
+    DOUBLE_NWORDS_MAX = (DOUBLE_DIGITS_MAX + DECI_BASE_LOG - 1) / DECI_BASE_LOG,
+    // (10^309 < 2^1027)
+    DOUBLE_NBITWORDS_MAX = (1027 + DECI_WORD_BITS - 1) / DECI_WORD_BITS,
+    // The number of digits taken from the top of the span.
+    DOUBLE_HEAD_DIGITS = 19,
+    // The bound on the error of 'M', see above.
+    DOUBLE_APPR_ERR = 64,
+};
+
+// 10^(2^k) = (mantissa 2^exp), with the mantissa truncated to 64 bits.
+static const struct {
+    uint64_t mantissa;
+    int exp;
+} TENPOW_POW2S[] = {
+    {UINT64_C(0xa000000000000000), -60},
+    {UINT64_C(0xc800000000000000), -57},
+    {UINT64_C(0x9c40000000000000), -50},
+    {UINT64_C(0xbebc200000000000), -37},
+    {UINT64_C(0x8e1bc9bf04000000), -10},
+    {UINT64_C(0x9dc5ada82b70b59d), 43},
+    {UINT64_C(0xc2781f49ffcfa6d5), 149},
+    {UINT64_C(0x93ba47c980e98cdf), 362},
+    {UINT64_C(0xaa7eebfb9df9de8d), 787},
+};
+
+// Returns the high 64 bits of (a b), writing the low ones into '*lo'.
+static inline DECI_FORCE_INLINE
+uint64_t mul_64x64(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#if DECI_WE_ARE_64_BIT
+    const deci_QUAD_UWORD p = ((deci_QUAD_UWORD) a) * b;
+    *lo = (uint64_t) p;
+    return (uint64_t) (p >> 64);
+#else
+    const uint64_t a_lo = (uint32_t) a, a_hi = a >> 32;
+    const uint64_t b_lo = (uint32_t) b, b_hi = b >> 32;
+    const uint64_t ll = a_lo * b_lo;
+    const uint64_t lh = a_lo * b_hi;
+    const uint64_t hl = a_hi * b_lo;
+    const uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+    *lo = (mid << 32) | (uint32_t) ll;
+    return a_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// Returns (x 2^e); this is exact, unless it overflows to infinity.
+static double double_scale2(double x, unsigned e)
+{
+    for (; e >= 63; e -= 63)
+        x *= (double) (UINT64_C(1) << 63);
+    return x * (double) (UINT64_C(1) << e);
+}
+
+// Returns the bits of 'x'. The bytes are copied one by one, which is well-defined in both C and
+// C++, and which compilers turn into a single move.
+static uint64_t double_bits(double x)
+{
+    uint64_t r;
+    const unsigned char *src = (const unsigned char *) &x;
+    unsigned char *dst = (unsigned char *) &r;
+    for (size_t i = 0; i < sizeof(r); ++i)
+        dst[i] = src[i];
+    return r;
+}
+
+// Multiplies (wa ... wa + n) by (f^k), where 'f' is 2 or 5, and returns the new size; the span
+// must have enough room for the result.
+static size_t mul_small_pow(deci_UWORD *wa, size_t n, deci_UWORD f, unsigned k)
+{
+    // The largest power of 'f' that is less than DECI_BASE.
+    deci_UWORD y_max = 1;
+    unsigned k_max = 0;
+    for (; y_max < DECI_BASE / f; y_max *= f)
+        ++k_max;
+
+    while (k) {
+        deci_UWORD y = y_max;
+        unsigned j = k_max;
+        if (k < k_max) {
+            for (y = 1, j = 0; j != k; ++j)
+                y *= f;
+        }
+        k -= j;
+        const deci_UWORD carry = deci_mul_uword(wa, wa + n, y);
+        if (carry)
+            wa[n++] = carry;
+    }
+    return n;
+}
+
+DECI_API
+size_t deci_from_double(double x, deci_UWORD *out, size_t *scale)
+{
+    const uint64_t bits = double_bits(x);
+    const unsigned biased_exp = (bits >> 52) & 0x7FF;
+    uint64_t m = bits & ((UINT64_C(1) << 52) - 1);
+    int e = -1074;
+    if (biased_exp) {
+        m |= UINT64_C(1) << 52;
+        e = ((int) biased_exp) - 1075;
+    }
+
+    size_t n = 0;
+    *scale = 0;
+    if (m) {
+        for (; e < 0 && !(m & 1); ++e)
+            m >>= 1;
+        for (; m; m /= DECI_BASE)
+            out[n++] = m % DECI_BASE;
+        if (e >= 0) {
+            n = mul_small_pow(out, n, 2, e);
+        } else {
+            n = mul_small_pow(out, n, 5, -e);
+            *scale = -e;
+        }
+    }
+
+    STATS(stats_call(DECI_STATS_FROM_DOUBLE, n);)
+
+    return n;
+}
+
+// Converts (wa ... wa + n), which must be normalized, have no more than 'DOUBLE_DIGITS_MAX' digits,
+// and be no less than 2^63, by converting it to binary whole.
+static double to_double_exact(const deci_UWORD *wa, size_t n)
+{
+    deci_UWORD a[DOUBLE_NWORDS_MAX];
+    deci_UWORD bits[DOUBLE_NBITWORDS_MAX];
+    deci_memcpy(a, wa, n);
+    size_t nbits = 0;
+    while (n) {
+        bits[nbits++] = deci_tobits_round(a, a + n);
+        n = deci_normalize_n(a, n);
+    }
+
+    size_t len = (nbits - 1) * DECI_WORD_BITS;
+    for (deci_UWORD top = bits[nbits - 1]; top; top >>= 1)
+        ++len;
+
+    // Take the top 64 bits, and set the lowest of them if any of the rest is set: this keeps the
+    // value on the same side of every midpoint between two doubles.
+    const size_t shift = len - 64;
+    uint64_t t = 0;
+    for (size_t i = len; i != shift;) {
+        --i;
+        t = (t << 1) | ((bits[i / DECI_WORD_BITS] >> (i % DECI_WORD_BITS)) & 1);
+    }
+    bool sticky = bits[shift / DECI_WORD_BITS] &
+                  ((((deci_DOUBLE_UWORD) 1) << (shift % DECI_WORD_BITS)) - 1);
+    for (size_t i = 0; i != shift / DECI_WORD_BITS; ++i)
+        sticky |= bits[i] != 0;
+
+    return double_scale2((double) (t | sticky), shift);
+}
+
+DECI_API
+double deci_to_double(deci_UWORD *wa, deci_UWORD *wa_end)
+{
+    STATS(stats_call(DECI_STATS_TO_DOUBLE, wa_end - wa);)
+
+    const size_t n = deci_normalize_n(wa, wa_end - wa);
+    if (!n)
+        return 0;
+
+    const deci_UWORD top = wa[n - 1];
+    unsigned top_digits = 1;
+    while (top_digits != DECI_BASE_LOG && top >= TENPOWS[top_digits])
+        ++top_digits;
+    if (n - 1 > (DOUBLE_DIGITS_MAX - top_digits) / DECI_BASE_LOG)
+        return double_scale2(1, 1024);
+    const size_t ndigits = (n - 1) * DECI_BASE_LOG + top_digits;
+
+    uint64_t h = top;
+    unsigned h_digits = top_digits;
+    size_t i = n - 1;
+    for (; i && h_digits + DECI_BASE_LOG <= DOUBLE_HEAD_DIGITS; h_digits += DECI_BASE_LOG) {
+        --i;
+        h = h * DECI_BASE + wa[i];
+    }
+    if (!i)
+        return (double) h;
+    const unsigned rest = DOUBLE_HEAD_DIGITS - h_digits;
+    if (rest)
+        h = h * TENPOWS[rest] + wa[i - 1] / TENPOWS[DECI_BASE_LOG - rest];
+
+    int exp = 0;
+    for (; !(h >> 63); h <<= 1)
+        --exp;
+    for (size_t d = ndigits - DOUBLE_HEAD_DIGITS, k = 0; d; d >>= 1, ++k) {
+        if (!(d & 1))
+            continue;
+        uint64_t lo;
+        const uint64_t hi = mul_64x64(h, TENPOW_POW2S[k].mantissa, &lo);
+        if (hi >> 63) {
+            h = hi;
+            exp += TENPOW_POW2S[k].exp + 64;
+        } else {
+            h = (hi << 1) | (lo >> 63);
+            exp += TENPOW_POW2S[k].exp + 63;
+        }
+    }
+
+    const unsigned dropped = h & 0x7FF;
+    if (dropped <= 0x400 && 0x400 - dropped < DOUBLE_APPR_ERR)
+        return to_double_exact(wa, n);
+    return double_scale2((double) ((h >> 11) + (dropped > 0x400)), exp + 11);
+}
+
+// ---------------------------------------------------------------------------------------
+// Resumable operations.
+//
+// These are the loops of 'deci_divmod_unsafe()', 'deci_mul()', and of repeated
+// 'deci_tobits_round()' and 'deci_frombits_round()', turned inside out: the loop variables and
+// carries live in the state, and each step runs the innermost loop over at most 'budget' words,
+// using the same kernels as the plain versions.
+// ---------------------------------------------------------------------------------------
+
+static inline size_t min_zu(size_t a, size_t b)
+{
+    return a < b ? a : b;
+}
+
+enum {
+    DIVMOD_SUB,
+    DIVMOD_ADD_BACK,
+    DIVMOD_DONE,
+};
+
+// Estimates the quotient word of the round on (st->r ... st->r_end), as 'long_div_round()' does,
+// and starts subtracting.
+static void divmod_start_round(deci_DivmodState *st)
+{
+    const deci_UWORD *r_end = st->r_end;
+    if ((size_t) (r_end - st->r) == st->nwb) {
+        st->q = estimate_quotient(
+            /*r1=*/0,
+            /*r23=*/combine(r_end[-1], r_end[-2]),
+            /*b12=*/st->b12);
+    } else {
+        st->q = estimate_quotient(
+            /*r1=*/r_end[-1],
+            /*r23=*/combine(r_end[-2], r_end[-3]),
+            /*b12=*/st->b12);
+    }
+
+    STATS(++stats.div_rounds;)
+
+    st->phase = DIVMOD_SUB;
+    st->i = 0;
+    st->mul_carry = 0;
+    st->carry = false;
+}
+
+// Stores the quotient word of the round and moves on to the next one, as 'deci_divmod_unsafe()'
+// does.
+static void divmod_end_round(deci_DivmodState *st)
+{
+    if (st->first_round) {
+        st->qhi = st->q;
+        st->first_round = false;
+    } else {
+        *--st->r_end = st->q;
+    }
+
+    if (st->r == st->wa) {
+        st->phase = DIVMOD_DONE;
+    } else {
+        --st->r;
+        divmod_start_round(st);
+    }
+}
+
+DECI_API
+void deci_divmod_begin(
+        deci_DivmodState *st,
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end)
+{
+    const size_t nwb = wb_end - wb;
+
+    st->wa = wa;
+    st->wb = wb;
+    st->nwb = nwb;
+    st->b12 = combine(wb_end[-1], wb_end[-2]);
+    st->r = wa_end - nwb;
+    st->r_end = wa_end;
+    st->first_round = true;
+    st->qhi = 0;
+
+    divmod_start_round(st);
+}
+
+// Does the work of 'deci_divmod_step()', counting '*budget' down by the words processed.
+static bool divmod_step(deci_DivmodState *st, size_t *budget)
+{
+    const size_t nwb = st->nwb;
+    deci_UWORD *wb = st->wb;
+
+    for (;;) {
+        deci_UWORD *r = st->r;
+        const size_t i = st->i;
+
+        switch (st->phase) {
+        case DIVMOD_SUB:
+            {
+                if (!*budget)
+                    return false;
+                const size_t n = min_zu(*budget, nwb - i);
+                *budget -= n;
+
+                BORROW borrow = -(BORROW) st->carry;
+                st->mul_carry = sub_scaled_run(r + i, st->q, wb + i, wb + i + n, st->mul_carry, &borrow);
+                st->carry = borrow;
+                st->i = i + n;
+                if (st->i != nwb)
+                    break;
+
+                // This is the end of 'deci_sub_scaled_raw()': the remainder has at most one more
+                // word than the divisor.
+                bool negative;
+                if ((size_t) (st->r_end - r) == nwb) {
+                    negative = st->mul_carry || borrow;
+                } else {
+                    negative = sbb(r + nwb, st->mul_carry, borrow);
+                }
+
+                if (negative) {
+                    STATS(++stats.div_corrections;)
+                    --st->q;
+                    st->phase = DIVMOD_ADD_BACK;
+                    st->i = 0;
+                    st->carry = false;
+                } else {
+                    divmod_end_round(st);
+                }
+            }
+            break;
+
+        case DIVMOD_ADD_BACK:
+            {
+                if (!*budget)
+                    return false;
+                const size_t n = min_zu(*budget, nwb - i);
+                *budget -= n;
+
+                CARRY carry = -(CARRY) st->carry;
+                for (size_t k = i; k != i + n; ++k)
+                    carry = adc(r + k, wb[k], carry);
+                st->carry = carry;
+                st->i = i + n;
+                if (st->i != nwb)
+                    break;
+
+                // The carry out cancels out the borrow of the subtraction; if the remainder has one
+                // more word than the divisor, that word is now zero, and is about to be overwritten
+                // with the quotient word anyway.
+
+                divmod_end_round(st);
+            }
+            break;
+
+        default:
+            return true;
+        }
+    }
+}
+
+DECI_API
+bool deci_divmod_step(deci_DivmodState *st, size_t budget)
+{
+    size_t left = budget;
+    const bool done = divmod_step(st, &left);
+    STATS(stats_call(DECI_STATS_DIVMOD_STEP, budget - left);)
+    return done;
+}
+
+DECI_API
+void deci_mul_begin(
+        deci_MulState *st,
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *out)
+{
+    // Same as in 'deci_mul()'.
+    if ((wa_end - wa) < (wb_end - wb)) {
+        SWAP(deci_UWORD *, wa, wb);
+        SWAP(deci_UWORD *, wa_end, wb_end);
+    }
+    st->wa = wa;
+    st->wa_end = wa_end;
+    st->wb = wb;
+    st->wb_end = wb_end;
+    st->out = out;
+    st->i = 0;
+    st->mul_carry = 0;
+    st->carry = false;
+}
+
+// Does the work of 'deci_mul_step()', counting '*budget' down by the words processed.
+static bool mul_step(deci_MulState *st, size_t *budget)
+{
+    deci_UWORD *wa = st->wa;
+    const size_t nwa = st->wa_end - wa;
+
+    // A row of 'deci_mul()' is a call of 'deci_add_scaled()'.
+    while (st->wb != st->wb_end) {
+        if (!*budget)
+            return false;
+        const size_t i = st->i;
+        const size_t n = min_zu(*budget, nwa - i);
+        *budget -= n;
+
+        CARRY carry = -(CARRY) st->carry;
+        st->mul_carry = add_scaled_run(st->out + i, *st->wb, wa + i, wa + i + n, st->mul_carry, &carry);
+        st->carry = carry;
+        st->i = i + n;
+
+        if (st->i == nwa) {
+            add_scaled_finish(st->out + nwa, st->mul_carry, carry);
+            ++st->wb;
+            ++st->out;
+            st->i = 0;
+            st->mul_carry = 0;
+            st->carry = false;
+        }
+    }
+    return true;
+}
+
+DECI_API
+bool deci_mul_step(deci_MulState *st, size_t budget)
+{
+    size_t left = budget;
+    const bool done = mul_step(st, &left);
+    STATS(stats_call(DECI_STATS_MUL_STEP, budget - left);)
+    return done;
+}
+
+DECI_API
+void deci_tobits_begin(deci_TobitsState *st, deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD *out)
+{
+    st->wa = wa;
+    st->wa_end = deci_normalize(wa, wa_end);
+    st->cur = st->wa_end;
+    st->carry = 0;
+    st->nout = 0;
+    st->out = out;
+}
+
+// Does the work of 'deci_tobits_step()', counting '*budget' down by the words processed.
+static bool tobits_step(deci_TobitsState *st, size_t *budget)
+{
+    deci_UWORD *wa = st->wa;
+
+    // A round is a call of 'deci_tobits_round()', from the most significant word down.
+    while (st->wa_end != wa) {
+        if (!*budget)
+            return false;
+        deci_UWORD *cur = st->cur;
+        deci_UWORD *const stop = cur - min_zu(*budget, cur - wa);
+        *budget -= cur - stop;
+
+        deci_UWORD carry = st->carry;
+        while (cur != stop) {
+            --cur;
+            const deci_DOUBLE_UWORD x = combine(carry, *cur);
+            *cur = x >> DECI_WORD_BITS;
+            carry = x;
+        }
+
+        if (cur == wa) {
+            st->out[st->nout++] = carry;
+            st->wa_end = deci_normalize(wa, st->wa_end);
+            cur = st->wa_end;
+            carry = 0;
+        }
+        st->cur = cur;
+        st->carry = carry;
+    }
+    return true;
+}
+
+DECI_API
+bool deci_tobits_step(deci_TobitsState *st, size_t budget)
+{
+    size_t left = budget;
+    const bool done = tobits_step(st, &left);
+    STATS(stats_call(DECI_STATS_TOBITS_STEP, budget - left);)
+    return done;
+}
+
+DECI_API
+void deci_frombits_begin(
+        deci_FrombitsState *st,
+        const deci_UWORD *bits, const deci_UWORD *bits_end,
+        deci_UWORD *out)
+{
+    st->bits = bits;
+    st->bits_end = bits_end;
+    st->i = 0;
+    st->carry = 0;
+    st->in_pass = false;
+    st->nout = 0;
+    st->out = out;
+}
+
+// Does the work of 'deci_frombits_step()', counting '*budget' down by the words processed.
+static bool frombits_step(deci_FrombitsState *st, size_t *budget)
+{
+    deci_UWORD *out = st->out;
+
+    // A pass multiplies the result by (2 raised to 'DECI_WORD_BITS'), as 'deci_frombits_round()'
+    // does, and adds the next binary word, most significant first, which is passed in as the
+    // initial carry; the final carry is then appended to the result, one word of work in total.
+    for (;;) {
+        if (st->i == st->nout && st->in_pass) {
+            if (!*budget)
+                return false;
+            --*budget;
+            for (deci_UWORD carry = st->carry; carry; carry /= DECI_BASE)
+                out[st->nout++] = carry % DECI_BASE;
+            st->in_pass = false;
+        }
+
+        if (!st->in_pass) {
+            if (st->bits_end == st->bits)
+                return true;
+            st->carry = *--st->bits_end;
+            st->i = 0;
+            st->in_pass = true;
+        }
+
+        if (!*budget)
+            return false;
+        const size_t i = st->i;
+        const size_t n = min_zu(*budget, st->nout - i);
+        *budget -= n;
+
+        deci_UWORD carry = st->carry;
+        for (size_t k = i; k != i + n; ++k) {
+            const deci_DOUBLE_UWORD x = (((deci_DOUBLE_UWORD) out[k]) << DECI_WORD_BITS) | carry;
+            out[k] = x % DECI_BASE;
+            carry = x / DECI_BASE;
+        }
+        st->carry = carry;
+        st->i = i + n;
+    }
+}
+
+DECI_API
+bool deci_frombits_step(deci_FrombitsState *st, size_t budget)
+{
+    size_t left = budget;
+    const bool done = frombits_step(st, &left);
+    STATS(stats_call(DECI_STATS_FROMBITS_STEP, budget - left);)
+    return done;
+}
+
+#if DECI_HEADER_ONLY
+#   undef SWAP
+#   undef CARRY_TO_1BIT
+#   undef BORROW_TO_1BIT
+#   undef STATS
+#   undef STATS_THREAD_LOCAL
+#endif
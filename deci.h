@@ -90,8 +90,128 @@
 #   endif
 #endif
 
+// Header-only mode.
+//
+// If 'DECI_HEADER_ONLY' is defined to a nonzero value before this header is included, the header
+// also includes 'deci.c', and all the functions are defined as 'static inline', so that the
+// compiler can inline the small operations -- those on spans of a few words, where the call and the
+// loop setup cost more than the arithmetic -- without link-time optimization. 'deci.c' then need not
+// be compiled; if it is, it exports nothing. Note that the internal names of 'deci.c' become
+// visible to the including file too, and that the 'DECI_STATS' counters are per translation unit.
+#if ! defined(DECI_HEADER_ONLY)
+#   define DECI_HEADER_ONLY 0
+#endif
+
+// Specifiers of the non-inline functions.
+#if ! defined(DECI_API)
+#   if DECI_HEADER_ONLY
+#       define DECI_API static inline DECI_UNUSED
+#   else
+#       define DECI_API /*nothing*/
+#   endif
+#endif
+
+// In the header-only mode, the functions are 'static', so their linkage does not matter; otherwise,
+// they are to be linked against 'deci.c' compiled as C.
+#if defined(__cplusplus) && ! DECI_HEADER_ONLY
+extern "C" {
+#endif
+
+// Symbol prefix.
+//
+// If 'DECI_SYMBOL_PREFIX' is defined when compiling 'deci.c' and everything that includes this
+// header, the non-inline functions are named with that prefix in place of 'deci_'; for example,
+// with '-DDECI_SYMBOL_PREFIX=deci16_', 'deci_add()' becomes 'deci16_add()'. This way, the library
+// can be linked into one binary more than once, in particular in both configurations (see
+// 'DECI_WE_ARE_64_BIT'); 'deci_regroup.h' converts spans from one configuration to the other.
+
+#if defined(DECI_SYMBOL_PREFIX)
+#   define DECI_SYMBOL_CONCAT_(X, Y) X ## Y
+#   define DECI_SYMBOL_CONCAT(X, Y) DECI_SYMBOL_CONCAT_(X, Y)
+#   define DECI_SYMBOL(Name) DECI_SYMBOL_CONCAT(DECI_SYMBOL_PREFIX, Name)
+#   define deci_add               DECI_SYMBOL(add)
+#   define deci_add_chunk         DECI_SYMBOL(add_chunk)
+#   define deci_sub_raw           DECI_SYMBOL(sub_raw)
+#   define deci_sub_raw_chunk     DECI_SYMBOL(sub_raw_chunk)
+#   define deci_uncomplement      DECI_SYMBOL(uncomplement)
+#   define deci_absdiff           DECI_SYMBOL(absdiff)
+#   define deci_absdiff_out       DECI_SYMBOL(absdiff_out)
+#   define deci_add_scaled        DECI_SYMBOL(add_scaled)
+#   define deci_sub_scaled_raw    DECI_SYMBOL(sub_scaled_raw)
+#   define deci_mul               DECI_SYMBOL(mul)
+#   define deci_mul_inplace       DECI_SYMBOL(mul_inplace)
+#   define deci_mullo             DECI_SYMBOL(mullo)
+#   define deci_mullo_add         DECI_SYMBOL(mullo_add)
+#   define deci_mulhi             DECI_SYMBOL(mulhi)
+#   define deci_mulhi_exact       DECI_SYMBOL(mulhi_exact)
+#   define deci_prod_uwords       DECI_SYMBOL(prod_uwords)
+#   define deci_factorial         DECI_SYMBOL(factorial)
+#   define deci_binomial          DECI_SYMBOL(binomial)
+#   define deci_mod_uword_multi   DECI_SYMBOL(mod_uword_multi)
+#   define deci_crt               DECI_SYMBOL(crt)
+#   define deci_divmod_unsafe     DECI_SYMBOL(divmod_unsafe)
+#   define deci_divmod_dword      DECI_SYMBOL(divmod_dword)
+#   define deci_divmod_tword      DECI_SYMBOL(divmod_tword)
+#   define deci_div               DECI_SYMBOL(div)
+#   define deci_mod               DECI_SYMBOL(mod)
+#   define deci_divrem            DECI_SYMBOL(divrem)
+#   define deci_div_appr          DECI_SYMBOL(div_appr)
+#   define deci_quotient          DECI_SYMBOL(quotient)
+#   define deci_divexact_uword    DECI_SYMBOL(divexact_uword)
+#   define deci_divexact          DECI_SYMBOL(divexact)
+#   define deci_tobits_round      DECI_SYMBOL(tobits_round)
+#   define deci_tolong            DECI_SYMBOL(tolong)
+#   define deci_long_tobits_round DECI_SYMBOL(long_tobits_round)
+#   define deci_frombits_round    DECI_SYMBOL(frombits_round)
+#   define deci_mul_pow2          DECI_SYMBOL(mul_pow2)
+#   define deci_divmod_pow2       DECI_SYMBOL(divmod_pow2)
+#   define deci_shl10             DECI_SYMBOL(shl10)
+#   define deci_shr10             DECI_SYMBOL(shr10)
+#   define deci_shr10_round       DECI_SYMBOL(shr10_round)
+#   define deci_pow               DECI_SYMBOL(pow)
+#   define deci_pow2              DECI_SYMBOL(pow2)
+#   define deci_sqrtrem           DECI_SYMBOL(sqrtrem)
+#   define deci_gcd               DECI_SYMBOL(gcd)
+#   define deci_gcdext            DECI_SYMBOL(gcdext)
+#   define deci_pack              DECI_SYMBOL(pack)
+#   define deci_unpacked_nwords   DECI_SYMBOL(unpacked_nwords)
+#   define deci_unpack            DECI_SYMBOL(unpack)
+#   define deci_from_double       DECI_SYMBOL(from_double)
+#   define deci_to_double         DECI_SYMBOL(to_double)
+#   define deci_divmod_begin      DECI_SYMBOL(divmod_begin)
+#   define deci_divmod_step       DECI_SYMBOL(divmod_step)
+#   define deci_mul_begin         DECI_SYMBOL(mul_begin)
+#   define deci_mul_step          DECI_SYMBOL(mul_step)
+#   define deci_tobits_begin      DECI_SYMBOL(tobits_begin)
+#   define deci_tobits_step       DECI_SYMBOL(tobits_step)
+#   define deci_frombits_begin    DECI_SYMBOL(frombits_begin)
+#   define deci_frombits_step     DECI_SYMBOL(frombits_step)
+#   define deci_stats_snapshot    DECI_SYMBOL(stats_snapshot)
+#   define deci_stats_reset       DECI_SYMBOL(stats_reset)
+#   define deci_stats_entry_name  DECI_SYMBOL(stats_entry_name)
+#endif
+
+// Machine-dependent thresholds. If a 'deci_tune.h' generated by the 'tune' program (see 'bench/')
+// is found next to this header, the thresholds are taken from it; define 'DECI_NO_TUNE_H' to
+// prevent that. Any of them can also be overridden individually.
+
+#if ! defined(DECI_NO_TUNE_H) && defined(__has_include)
+#   if __has_include("deci_tune.h")
+#       include "deci_tune.h"
+#   endif
+#endif
+
+// 'deci_gcd()' and 'deci_gcdext()' only do Lehmer steps while the operands are at least this many
+// words long, and plain division steps otherwise. Values less than 2 mean the same as 2.
+#if ! defined(DECI_GCD_LEHMER_THRESHOLD)
+#   define DECI_GCD_LEHMER_THRESHOLD 2
+#endif
+
 // We *really* want to be able to natively divide 'deci_DOUBLE_UWORD' values, so it has to be
 // 64-bit on 64-bit systems, and 32-bit on 32-bit systems.
+//
+// 'DECI_BASE_BITS' is the bit length of (DECI_BASE - 1), so that every word is less than
+// (2 raised to 'DECI_BASE_BITS'), and 2^(DECI_BASE_BITS - 1) is less than DECI_BASE.
 
 #if DECI_WE_ARE_64_BIT
 
@@ -103,7 +223,10 @@ typedef unsigned __int128   deci_QUAD_UWORD;
 #define DECI_BASE_LOG 9
 #define DECI_WORD_BITS 32
 #define DECI_DOUBLE_WORD_BITS 64
+#define DECI_MULHI_GUARD 2
 DECI_UNUSED static const deci_UWORD DECI_BASE = 1000000000;
+#define DECI_BASE_BITS 30
+#define DECI_PACKED_BITS DECI_BASE_BITS
 #define DECI_FOR_EACH_TENPOW(X) \
     X(0, 1) \
     X(1, 10) \
@@ -125,7 +248,10 @@ typedef uint64_t deci_QUAD_UWORD;
 #define DECI_BASE_LOG 4
 #define DECI_WORD_BITS 16
 #define DECI_DOUBLE_WORD_BITS 32
+#define DECI_MULHI_GUARD 3
 DECI_UNUSED static const deci_UWORD DECI_BASE = 10000;
+#define DECI_BASE_BITS 14
+#define DECI_PACKED_BITS DECI_BASE_BITS
 #define DECI_FOR_EACH_TENPOW(X) \
     X(0, 1) \
     X(1, 10) \
@@ -145,10 +271,22 @@ DECI_UNUSED static const deci_UWORD DECI_BASE = 10000;
 //    * if return value is true, the addition overflowed (wa .. wa_end); the most significant word
 //      of the result is ((deci_UWORD) 1), and the rest of the words were written into
 //      (wa ... wa_end).
+DECI_API
 bool deci_add(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end);
 
+// Same as 'deci_add()', but also adds 'carry' (as the least significant word).
+//
+// This and the other '*_chunk()' functions allow a long operation to be done piecewise, one chunk
+// of the operands at a time, passing the return value of one call as the carry of the next one;
+// see 'deci_file.h'.
+DECI_API
+bool deci_add_chunk(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        bool carry);
+
 // Subtracts (wb ... wb_end) from (wa ... wa_end), writing the result into (wa ... wa_end).
 //
 // Assumes (wa_end - wa) >= (wb_end - wb); otherwise, the behavior is undefined.
@@ -171,10 +309,18 @@ bool deci_add(
 //
 //      Use 'deci_uncomplement()' to convert the ten's complement value of the negative result to
 //      its absolute value.
+DECI_API
 bool deci_sub_raw(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end);
 
+// Same as 'deci_sub_raw()', but also subtracts 'borrow' (as the least significant word).
+DECI_API
+bool deci_sub_raw_chunk(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        bool borrow);
+
 // Performs the following subtraction, writing the result into (wa ... wa_end):
 //     {1 000 ... 000} - (wa ... wa_end),
 // where:
@@ -185,6 +331,7 @@ bool deci_sub_raw(
 //
 // If (wa ... wa_end) represents the value of zero, returns false and does not alter the span.
 // Otherwise, performs the modification described above and returns true.
+DECI_API
 bool deci_uncomplement(deci_UWORD *wa, deci_UWORD *wa_end);
 
 // Subtracts two (deci_UWORD*) spans, writing the result into (wa ... wa_end).
@@ -212,18 +359,37 @@ bool deci_sub(
     return underflow;
 }
 
-// Multiplies (wa ... wa_end) by 'b'.
+// Same as 'deci_sub()', but never makes a second pass: the spans are first compared from the most
+// significant words down to the first one that differs, and then the smaller is subtracted from
+// the greater, only up to that word. The words above it are zeroed out.
 //
-// Assumes (b < DECI_BASE); otherwise, the behavior is undefined.
+// Assumes (wa_end - wa) >= (wb_end - wb); otherwise, the behavior is undefined.
 //
-// Returns the most significant word of the result, writing the rest of the words into
-// (wa ... wa_end).
+// Returns true if (wa ... wa_end) was less than (wb ... wb_end); either way, what is stored in
+// (wa ... wa_end) is the absolute value of the difference.
+DECI_API
+bool deci_absdiff(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end);
+
+// Same as 'deci_absdiff()', but writes the result into (out ... out + (wa_end - wa)) instead, and
+// leaves (wa ... wa_end) alone. 'out' may be equal to 'wa', or, if it has that capacity, to 'wb'.
+DECI_API
+bool deci_absdiff_out(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *out);
+
+// Same as 'deci_mul_uword()' (see below), but also adds 'carry' to the product; the chunks go from
+// the least significant one up.
+//
+// Assumes (b < DECI_BASE) and (carry < DECI_BASE); otherwise, the behavior is undefined.
 static inline DECI_UNUSED
-deci_UWORD deci_mul_uword(
+deci_UWORD deci_mul_uword_chunk(
         deci_UWORD *wa, deci_UWORD *wa_end,
-        deci_UWORD b)
+        deci_UWORD b,
+        deci_UWORD carry)
 {
-    deci_UWORD carry = 0;
     for (; wa != wa_end; ++wa) {
         const deci_DOUBLE_UWORD x = *wa * ((deci_DOUBLE_UWORD) b) + carry;
         *wa = x % DECI_BASE;
@@ -232,6 +398,20 @@ deci_UWORD deci_mul_uword(
     return carry;
 }
 
+// Multiplies (wa ... wa_end) by 'b'.
+//
+// Assumes (b < DECI_BASE); otherwise, the behavior is undefined.
+//
+// Returns the most significant word of the result, writing the rest of the words into
+// (wa ... wa_end).
+static inline DECI_UNUSED
+deci_UWORD deci_mul_uword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD b)
+{
+    return deci_mul_uword_chunk(wa, wa_end, b, 0);
+}
+
 // Adds ((wz ... wz_end) times 'y') to (wx ... implied_wx_end), modifying the latter.
 //
 // Assumes (y < DECI_BASE); otherwise, the behavior is undefined.
@@ -240,6 +420,7 @@ deci_UWORD deci_mul_uword(
 //     N >= (wz_end - wz),
 // where N = (implied_wx_end - wx), or, in other words, the number of words behind the 'wx' pointer.
 // Otherwise, the behavior is undefined.
+DECI_API
 void deci_add_scaled(
     deci_UWORD *wx,
     deci_UWORD y,
@@ -253,6 +434,7 @@ void deci_add_scaled(
 //
 // Return the "borrow" word: the word that would have to be subtracted from (*wx_end), if it was
 // legal to access.
+DECI_API
 deci_UWORD deci_sub_scaled_raw(
         deci_UWORD *wx, deci_UWORD *wx_end,
         deci_UWORD y,
@@ -264,29 +446,174 @@ deci_UWORD deci_sub_scaled_raw(
 //
 // Assumes 'out' is a pointer to N words, ALL INITIALLY ZEROED OUT; otherwise, the behavior is
 // undefined.
+DECI_API
 void deci_mul(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end,
         deci_UWORD *out);
 
-// Divides (wa ... wa_end) by 'b', writing the quotient into (wa ... wa_end), and returning the
-// remainder.
+// Same as 'deci_mul()', but writes the result over 'a': into (wa ... wa + N), where
+// N = (wa_end - wa) + (wb_end - wb). The words (wa_end ... wa + N) need not be zeroed out.
 //
-// Assumes (0 < b < DECI_BASE); otherwise, the behavior is undefined.
+// Assumes 'wa' is a pointer to N words, and that (wb ... wb_end) does not overlap with them;
+// otherwise, the behavior is undefined.
+//
+// Takes about as much time as 'deci_mul()', unless 'b' is much shorter than 'a' (but longer than
+// one word): the inner loop goes over 'b' here, so 'deci_mul()' is faster then, if there is memory
+// for it.
+DECI_API
+void deci_mul_inplace(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end);
+
+// Multiplies (wa ... wa + n) by (wb ... wb + n) modulo (DECI_BASE^n), that is, computes only the n
+// least significant words of the product, writing them into (out ... out + n); 'out' need not be
+// zeroed out. This takes about half the work of 'deci_mul()', and no carries out of the top word.
+//
+// 'out' may be equal to 'wa' or to 'wb', for the multiplication in place; otherwise, it must not
+// overlap with either operand. 'wa' and 'wb' must not both be equal to 'out'.
+DECI_API
+void deci_mullo(
+        deci_UWORD *wa,
+        deci_UWORD *wb,
+        size_t n,
+        deci_UWORD *out);
+
+// Computes (a b + c) modulo (DECI_BASE^n), where 'a', 'b' and 'c' are (wa ... wa + n),
+// (wb ... wb + n) and (wc ... wc + n), writing the result into (wa ... wa + n). The addition of 'c'
+// costs nothing on top of 'deci_mullo()'.
+//
+// Assumes that (wa ... wa + n) does not overlap with the other spans; otherwise, the behavior is
+// undefined.
+DECI_API
+void deci_mullo_add(
+        deci_UWORD *wa,
+        deci_UWORD *wb,
+        deci_UWORD *wc,
+        size_t n);
+
+// Computes the N most significant words of the product of (wa ... wa_end) by (wb ... wb_end), that
+// is, the product's words from (K = (wa_end - wa) + (wb_end - wb) - N) up, along with
+// 'DECI_MULHI_GUARD' more words below them, by adding up only the partial products that reach these
+// words; this skips about half the work of 'deci_mul()' when N is about the length of the operands.
+//
+// The result 'Q' is written into (out ... out + N + DECI_MULHI_GUARD); 'out' need not be zeroed.
+// With T = (K - DECI_MULHI_GUARD), and P being the product,
+//     Q <= floor(P / DECI_BASE^T) < Q + m * DECI_BASE,
+// where m = min(wa_end - wa, wb_end - wb). The N most significant words of 'Q' are therefore either
+// those of the product, or one unit less. If T is negative, the result is exact, with (-T) zero
+// words below the product.
+//
+// Assumes (N <= (wa_end - wa) + (wb_end - wb)), m < DECI_BASE^(DECI_MULHI_GUARD - 1), and that 'out'
+// does not overlap with either operand; otherwise, the behavior is undefined.
+DECI_API
+void deci_mulhi(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        size_t n,
+        deci_UWORD *out);
+
+// Same as 'deci_mulhi()', but writes the exact N most significant words of the product, that is,
+// the product divided by DECI_BASE^K and truncated, into (out ... out + N); 'out' must still have
+// capacity of (N + DECI_MULHI_GUARD) words. The words below are only computed when the guard
+// words are too close to overflowing into the result to tell, which happens with probability of
+// about (m / DECI_BASE^(DECI_MULHI_GUARD - 1)).
+//
+// 'scratch' must have capacity of K words.
+DECI_API
+void deci_mulhi_exact(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        size_t n,
+        deci_UWORD *out,
+        deci_UWORD *scratch);
+
+// Computes the product of the 'n' words (factors ... factors + n), writing it into
+// (out ... out + N), where N is the return value. If 'n' is zero, the product is 1.
+//
+// The factors are first multiplied together in groups that fit into two words, and the groups are
+// then multiplied pairwise, up a balanced tree, so that the operands of each 'deci_mul()' are of
+// about the same size.
+//
+// 'out' and 'scratch' must have capacity of (n + 2) words each; neither must overlap with the
+// other or with (factors ... factors + n).
+DECI_API
+size_t deci_prod_uwords(const deci_UWORD *factors, size_t n, deci_UWORD *out, deci_UWORD *scratch);
+
+// Returns the number of words that 'out' and 'scratch' must each have for 'deci_factorial(n)'.
 static inline DECI_UNUSED
-deci_UWORD deci_divmod_uword(
+size_t deci_factorial_nwords_max(size_t n)
+{
+    return n < DECI_BASE ? n + 2 : 2 * n;
+}
+
+// Computes the factorial of 'n' in the same way as 'deci_prod_uwords()', writing it into
+// (out ... out + N), where N is the return value.
+//
+// Assumes (n < DECI_BASE^2); otherwise, the behavior is undefined.
+//
+// 'out' and 'scratch' must have capacity of 'deci_factorial_nwords_max(n)' words each, and must
+// not overlap.
+DECI_API
+size_t deci_factorial(size_t n, deci_UWORD *out, deci_UWORD *scratch);
+
+// Returns the number of words that 'out' must have for 'deci_binomial(n, k)'; 'scratch' must have
+// twice as many.
+static inline DECI_UNUSED
+size_t deci_binomial_nwords_max(size_t n, size_t k)
+{
+    if (k > n)
+        return 1;
+    if (k > n - k)
+        k = n - k;
+    return n < DECI_BASE ? k + 2 : 2 * k + 2;
+}
+
+// Computes the binomial coefficient of 'n' over 'k', that is, (n! / (k! (n - k)!)), writing it into
+// (out ... out + N), where N is the return value. With k' = min(k, n - k), the product of the k'
+// greatest integers up to 'n' and the factorial of k' are computed in the same way as
+// 'deci_prod_uwords()', and the former is divided by the latter with 'deci_divexact()'.
+//
+// If (k > n), the result is zero.
+//
+// Assumes (n < DECI_BASE^2); otherwise, the behavior is undefined.
+//
+// 'out' must have capacity of 'deci_binomial_nwords_max(n, k)' words, and 'scratch' of twice as
+// many; they must not overlap.
+DECI_API
+size_t deci_binomial(size_t n, size_t k, deci_UWORD *out, deci_UWORD *scratch);
+
+// Same as 'deci_divmod_uword()' (see below), but (wa ... wa_end) is taken to be preceded by the more
+// significant word(s) that left the remainder of 'rem'; the chunks go from the most significant one
+// down.
+//
+// Assumes (0 < b < DECI_BASE) and (rem < b); otherwise, the behavior is undefined.
+static inline DECI_UNUSED
+deci_UWORD deci_divmod_uword_chunk(
         deci_UWORD *wa, deci_UWORD *wa_end,
-        deci_UWORD b)
+        deci_UWORD b,
+        deci_UWORD rem)
 {
-    deci_UWORD carry = 0;
     while (wa_end != wa) {
         --wa_end;
 
-        const deci_DOUBLE_UWORD x = *wa_end + DECI_BASE * (deci_DOUBLE_UWORD) carry;
+        const deci_DOUBLE_UWORD x = *wa_end + DECI_BASE * (deci_DOUBLE_UWORD) rem;
         *wa_end = x / b;
-        carry = x % b;
+        rem = x % b;
     }
-    return carry;
+    return rem;
+}
+
+// Divides (wa ... wa_end) by 'b', writing the quotient into (wa ... wa_end), and returning the
+// remainder.
+//
+// Assumes (0 < b < DECI_BASE); otherwise, the behavior is undefined.
+static inline DECI_UNUSED
+deci_UWORD deci_divmod_uword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD b)
+{
+    return deci_divmod_uword_chunk(wa, wa_end, b, 0);
 }
 
 // Returns the remainder of division of (wa ... wa_end) by 'b'.
@@ -307,6 +634,31 @@ deci_UWORD deci_mod_uword(
     return carry;
 }
 
+// Writes the remainders of division of (wa ... wa_end) by each of 'divisors[0]', ...,
+// 'divisors[k - 1]' into 'out[0]', ..., 'out[k - 1]'. Up to 32 divisors are handled in a single
+// pass over the span, so this is much faster than calling 'deci_mod_uword()' k times.
+//
+// Assumes (0 < divisors[i] < DECI_BASE) for all i; otherwise, the behavior is undefined.
+DECI_API
+void deci_mod_uword_multi(
+        const deci_UWORD *wa, const deci_UWORD *wa_end,
+        const deci_UWORD *divisors, size_t k,
+        deci_UWORD *out);
+
+// The inverse of 'deci_mod_uword_multi()' (the Chinese remainder theorem): writes the number x,
+// 0 <= x < (moduli[0] * ... * moduli[k - 1]), such that (x mod moduli[i] = residues[i]) for all i,
+// into (out ... out + N), where N is the return value, N <= k; 'out' must have capacity of k words.
+//
+// Takes O(k^2) word operations.
+//
+// Assumes that (0 < moduli[i] < DECI_BASE) and (residues[i] < moduli[i]) for all i, and that the
+// moduli are pairwise coprime; otherwise, the behavior is undefined.
+DECI_API
+size_t deci_crt(
+        const deci_UWORD *residues,
+        const deci_UWORD *moduli, size_t k,
+        deci_UWORD *out);
+
 // Divides (wa ... wa_end) by (wb ... wb_end).
 //
 // Writes the remainder into (wa ... wa + N), where N = (wb_end - wb).
@@ -320,16 +672,37 @@ deci_UWORD deci_mod_uword(
 //
 //   * (wa_end - wa) >= N >= 2. Note that if N == 1, you should use either 'deci_divmod_uword' or
 //       'deci_mod_uword'; and if N == 0, you are dividing by zero -- oops.
+DECI_API
 deci_UWORD deci_divmod_unsafe(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end);
 
+// Divides (wa ... wa_end) by 'b', writing the quotient into (wa ... wa_end), and returning the
+// remainder. This is what 'deci_div()' and 'deci_mod()' use for divisors of two words: instead of
+// the rounds of 'deci_divmod_unsafe()', each quotient word is estimated with a reciprocal of 'b'
+// computed once, and then corrected at most twice, all without leaving registers.
+//
+// Assumes (0 < b < DECI_BASE^2); otherwise, the behavior is undefined.
+DECI_API
+deci_DOUBLE_UWORD deci_divmod_dword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_DOUBLE_UWORD b);
+
+// Same as 'deci_divmod_dword()', but for divisors of three words.
+//
+// Assumes (0 < b < DECI_BASE^3); otherwise, the behavior is undefined.
+DECI_API
+deci_QUAD_UWORD deci_divmod_tword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_QUAD_UWORD b);
+
 // Divides (wa ... wa_end) by (wb ... wb_end).
 //
 // The quotient is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa).
 // The value of (wa + N ... wa_end) after this function returns is undefined.
 //
 // Assumes that (wb ... wb_end) does not represent the value of zero.
+DECI_API
 size_t deci_div(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end);
@@ -340,12 +713,97 @@ size_t deci_div(
 // The value of (wa + N ... wa_end) after this function returns is undefined.
 //
 // Assumes that (wb ... wb_end) does not represent the value of zero.
+DECI_API
 size_t deci_mod(
         deci_UWORD *wa, deci_UWORD *wa_end,
         deci_UWORD *wb, deci_UWORD *wb_end);
 
+// Divides (wa ... wa_end) by (wb ... wb_end), leaving both unchanged.
+//
+// The quotient is written into (q_out ... q_out + N), where N is the return value,
+// N <= (wa_end - wa); 'q_out' must have capacity of (wa_end - wa) words.
+//
+// The remainder is written into (r_out ... r_out + *nr); 'r_out' is also used as the working area
+// and must have capacity of (wa_end - wa) words. The value of (r_out + *nr ... r_out + (wa_end - wa))
+// after this function returns is undefined.
+//
+// Neither 'q_out' nor 'r_out' may overlap with any other span.
+//
+// Assumes that (wb ... wb_end) does not represent the value of zero.
+DECI_API
+size_t deci_divrem(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *r_out, size_t *nr);
+
+// Computes an approximation 'q1' of the quotient 'q' of (wa ... wa_end) divided by (wb ... wb_end),
+// such that
+//     q <= q1 <= q + 1,
+// leaving both spans unchanged. If the quotient has K words, only the (K + 1) most significant
+// words of the divisor are looked at, so when the divisor is much longer than the quotient, this
+// is much faster than the full division.
+//
+// 'q1' is written into (q_out ... q_out + N), where N is the return value, N <= (wa_end - wa);
+// 'q_out' must have capacity of (wa_end - wa) words.
+//
+// 'scratch' must have capacity of (wa_end - wa) words.
+//
+// Neither 'q_out' nor 'scratch' may overlap with any other span.
+//
+// Assumes that (wb ... wb_end) does not represent the value of zero.
+DECI_API
+size_t deci_div_appr(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *scratch);
+
+// Same as 'deci_div_appr()', but computes the exact quotient. The correction needs the rest of the
+// divisor only in the rare case when the approximate remainder is small.
+//
+// 'scratch' must have capacity of (2 * (wa_end - wa)) words.
+DECI_API
+size_t deci_quotient(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *q_out,
+        deci_UWORD *scratch);
+
+// Divides (wa ... wa_end) by 'b', writing the quotient into (wa ... wa_end), given that the
+// division is exact. Unlike 'deci_divmod_uword()', this goes from the least significant word
+// upwards and does not divide by 'b' for every word, only multiplies.
+//
+// Assumes (0 < b < DECI_BASE) and that (wa ... wa_end) is divisible by 'b'; otherwise, the behavior
+// is undefined.
+DECI_API
+void deci_divexact_uword(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD b);
+
+// Divides (wa ... wa_end) by (wb ... wb_end), given that the division is exact, leaving the latter
+// unchanged. This is Jebelean's algorithm: each quotient word is found from the least
+// significant remaining word of the dividend, without any estimation or correction steps, and only
+// the words that can still affect the quotient are updated. It is up to two times faster than
+// 'deci_div()'.
+//
+// The quotient is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa).
+// The value of (wa + N ... wa_end) after this function returns is undefined.
+//
+// 'scratch' must have capacity of (wb_end - wb) words; it is only used if the least significant
+// non-zero word of the divisor is divisible by 2 or 5.
+//
+// Assumes that (wb ... wb_end) does not represent the value of zero and that (wa ... wa_end) is
+// divisible by it; otherwise, the behavior is undefined.
+DECI_API
+size_t deci_divexact(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *scratch);
+
 // Divides (wa ... wa_end) by (2 raised to 'DECI_WORD_BITS'), writing the quotient into
 // (wa ... wa_end), and returning the remainder.
+DECI_API
 deci_UWORD deci_tobits_round(deci_UWORD *wa, deci_UWORD *wa_end);
 
 // Converts a normal 'deci_UWORD *' span to a "long" span of 'deci_DOUBLE_UWORD *'.
@@ -354,10 +812,12 @@ deci_UWORD deci_tobits_round(deci_UWORD *wa, deci_UWORD *wa_end);
 //     CEIL_HALF(wa_end - wa)
 // double words, where
 //     CEIL_HALF(n) = (n / 2) + (n % 2).
+DECI_API
 void deci_tolong(deci_UWORD *wa, deci_UWORD *wa_end, deci_DOUBLE_UWORD *out);
 
 // Divides (wd ... wd_end) by (2 raised to 'DECI_DOUBLE_WORD_BITS'), writing the quotient into
 // (wd ... wd_end), and returning the remainder.
+DECI_API
 deci_DOUBLE_UWORD deci_long_tobits_round(deci_DOUBLE_UWORD *wd, deci_DOUBLE_UWORD *wd_end);
 
 // Multiplies (wa ... wa_end) by (2 raised to 'DECI_WORD_BITS').
@@ -369,8 +829,476 @@ deci_DOUBLE_UWORD deci_long_tobits_round(deci_DOUBLE_UWORD *wd, deci_DOUBLE_UWOR
 // significant word is 'lo', then
 //     hi * DECI_BASE + lo
 // is returned. Note that the result always fits into a 'deci_UWORD'.
+DECI_API
 deci_UWORD deci_frombits_round(deci_UWORD *wa, deci_UWORD *wa_end);
 
+// Multiplies (wa ... wa_end) by (2 raised to 'k'), a pass per (DECI_DOUBLE_WORD_BITS -
+// DECI_BASE_BITS) bits of 'k'.
+//
+// Assumes that the result is less than (DECI_BASE ^ (N + 1)), where N = (wa_end - wa); otherwise,
+// the behavior is undefined.
+//
+// Returns the most significant word of the result, writing the rest of the words into
+// (wa ... wa_end).
+DECI_API
+deci_UWORD deci_mul_pow2(deci_UWORD *wa, deci_UWORD *wa_end, size_t k);
+
+// Divides (wa ... wa_end) by (2 raised to 'k'), truncating the result, a pass per
+// (3 * DECI_WORD_BITS) bits of 'k'.
+//
+// The quotient is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa).
+// The words (wa + N ... wa_end) are zeroed out.
+//
+// If 'rem' is not NULL, the remainder, that is, the 'k' bits that were shifted out, is written into
+// (rem ... rem + M) in binary, 'DECI_WORD_BITS' bits per word, least significant first, where
+//     M = (k / DECI_WORD_BITS) + !!(k % DECI_WORD_BITS).
+// (rem ... rem + M) must not overlap with (wa ... wa_end).
+DECI_API
+size_t deci_divmod_pow2(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem);
+
+// Multiplies (wa ... wa_end) by (10 raised to 'k').
+//
+// Assumes that the (k / DECI_BASE_LOG) most significant words of (wa ... wa_end) are zero;
+// otherwise, the behavior is undefined.
+//
+// Returns the most significant word of the result, writing the rest of the words into
+// (wa ... wa_end).
+DECI_API
+deci_UWORD deci_shl10(deci_UWORD *wa, deci_UWORD *wa_end, size_t k);
+
+// Divides (wa ... wa_end) by (10 raised to 'k'), truncating the result.
+//
+// The quotient is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa).
+// The words (wa + N ... wa_end) are zeroed out.
+//
+// If 'rem' is not NULL, the digits that were shifted out, that is, the remainder of the division,
+// are written into (rem ... rem + M), where
+//     M = (k / DECI_BASE_LOG) + !!(k % DECI_BASE_LOG).
+// (rem ... rem + M) must not overlap with (wa ... wa_end).
+DECI_API
+size_t deci_shr10(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem);
+
+// Same as 'deci_shr10()', but rounds the quotient to the nearest integer, with ties going to the
+// even one (the "banker's rounding").
+//
+// Note that if 'rem' is not NULL, it receives the exact digits that were shifted out, regardless
+// of the direction in which the quotient was rounded.
+DECI_API
+size_t deci_shr10_round(deci_UWORD *wa, deci_UWORD *wa_end, size_t k, deci_UWORD *rem);
+
+// Returns the number of words that 'out' and 'scratch' must each have for 'deci_pow()' of a base of
+// 'n' words, normalized, to the power of 'k'; this is the size of ((DECI_BASE^n - 1) raised to 'k').
+static inline DECI_UNUSED
+size_t deci_pow_nwords_max(size_t n, size_t k)
+{
+    return (n && k) ? n * k : 1;
+}
+
+// Raises (wa ... wa_end) to the power of 'k', writing the result into (out ... out + N), where N is
+// the return value. Zero to the power of zero is one.
+//
+// The power is computed by left-to-right binary exponentiation, a squaring per bit of 'k' and a
+// multiplication by the base per non-zero bit. Bases that are powers of ten are shifted into place
+// instead, and a base of 2 is handed to 'deci_pow2()'.
+//
+// 'out' and 'scratch' must have capacity of 'deci_pow_nwords_max(M, k)' words each, where M is the
+// size of (wa ... wa_end) without the leading zero words; neither must overlap with the other or
+// with (wa ... wa_end).
+DECI_API
+size_t deci_pow(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        size_t k,
+        deci_UWORD *out,
+        deci_UWORD *scratch);
+
+// Returns the number of words that 'out' and 'scratch' must each have for 'deci_pow2(k)'. This is
+// at most two words more than the size of the result: one, because 2^k is taken to have
+// (floor(k L) + 1) digits, with L = 1292913987 / 2^32 slightly greater than log10(2); and another,
+// for the last squaring, whose product may take a word more than its value.
+static inline DECI_UNUSED
+size_t deci_pow2_nwords_max(size_t k)
+{
+    const uint64_t l = 1292913987;
+    const uint64_t k64 = k;
+    const uint64_t ndigits = (k64 >> 32) * l + (((k64 & 0xffffffffu) * l) >> 32) + 1;
+    return (size_t) ((ndigits + DECI_BASE_LOG - 1) / DECI_BASE_LOG) + 1;
+}
+
+// Computes 2 raised to 'k', writing it into (out ... out + N), where N is the return value.
+//
+// The bits of 'k' are taken from the most significant one: those that give a power of two less
+// than DECI_BASE make up the first word, and each of the rest is a squaring, followed by a
+// doubling if the bit is set. This takes about (N * N / 6) word multiplications, most of them in
+// the last squaring.
+//
+// 'out' and 'scratch' must have capacity of 'deci_pow2_nwords_max(k)' words each, and must not
+// overlap.
+DECI_API
+size_t deci_pow2(size_t k, deci_UWORD *out, deci_UWORD *scratch);
+
+// Computes the integer square root of (wa ... wa_end), that is, the maximal 's' such that
+// (s times s) is not greater than (wa ... wa_end), and the remainder, that is, the value of
+// (wa ... wa_end) minus (s times s).
+//
+// The square root is written into (out ... out + N), where N is the return value,
+//     N <= CEIL_HALF(wa_end - wa),
+// where
+//     CEIL_HALF(n) = (n / 2) + (n % 2).
+//
+// The remainder is written into (wa ... wa_end).
+//
+// 'out' must have capacity of (CEIL_HALF(wa_end - wa) + 1) words, and must not overlap with
+// (wa ... wa_end); the value of (out + N ... out + CEIL_HALF(wa_end - wa) + 1) after this function
+// returns is undefined.
+DECI_API
+size_t deci_sqrtrem(deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD *out);
+
+// Computes the greatest common divisor of (wa ... wa_end) and (wb ... wb_end).
+//
+// The result is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa).
+// The values of (wa + N ... wa_end) and (wb ... wb_end) after this function returns are undefined.
+//
+// Assumes (wa_end - wa) >= (wb_end - wb); otherwise, the behavior is undefined.
+//
+// 'scratch' must have capacity of (wa_end - wa) words, and must not overlap with either of the
+// spans.
+//
+// If both spans represent the value of zero, the result is zero.
+DECI_API
+size_t deci_gcd(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *scratch);
+
+// Computes the greatest common divisor, 'g', of (wa ... wa_end) and (wb ... wb_end), and the
+// cofactor 's' such that
+//     g = s * (wa ... wa_end) + t * (wb ... wb_end)
+// for some integer 't'.
+//
+// 'g' is written into (wa ... wa + N), where N is the return value, N <= (wa_end - wa). The values
+// of (wa + N ... wa_end) and (wb ... wb_end) after this function returns are undefined.
+//
+// The absolute value of 's' is written into (ws ... ws + *nws); '*s_negative' is set to whether
+// 's' is negative. The absolute value of 's' is never greater than (wb ... wb_end), unless the
+// latter represents the value of zero, in which case 's' is one.
+//
+// Assumes (wa_end - wa) >= (wb_end - wb); otherwise, the behavior is undefined.
+//
+// 'ws' must have capacity of (M + 1) words, where M = (wb_end - wb); 'scratch' must have capacity
+// of ((wa_end - wa) + 2 * (M + 1)) words. Neither must overlap with any other span.
+DECI_API
+size_t deci_gcdext(
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *ws, size_t *nws, bool *s_negative,
+        deci_UWORD *scratch);
+
+// Packed format.
+//
+// A word only needs 'DECI_PACKED_BITS' bits (the same as 'DECI_BASE_BITS', the smallest number of
+// bits that can hold (DECI_BASE - 1)), which is 30 of 32, or 14 of 16. The packed format of a span is:
+//
+//   * the number N of words in the normalized span, in LEB128 (7 bits per byte, least significant
+//     first, the high bit set on all bytes but the last), in as few bytes as possible, so that the
+//     last byte is zero only if it is the only one;
+//
+//   * the N words, 'DECI_PACKED_BITS' bits each, as a little-endian bit stream: bit 'j' of word 'i'
+//     is bit ((i * DECI_PACKED_BITS + j) % 8) of byte ((i * DECI_PACKED_BITS + j) / 8); the unused
+//     bits of the last byte are zero.
+//
+// Note that the format depends on the word size: it is not the same for the two configurations.
+
+// Returns the maximum size, in bytes, of the packed format of an N-word span.
+static inline DECI_UNUSED
+size_t deci_packed_size_max(size_t n)
+{
+    return (sizeof(size_t) * 8 + 6) / 7 + (n / 4) * DECI_PACKED_BITS / 2 +
+           ((n % 4) * DECI_PACKED_BITS + 7) / 8;
+}
+
+// Writes the packed format of (wa ... wa_end) into 'out', which must have capacity of
+// 'deci_packed_size_max(wa_end - wa)' bytes, and returns the number of bytes written.
+DECI_API
+size_t deci_pack(deci_UWORD *wa, deci_UWORD *wa_end, unsigned char *out);
+
+// Returns the number of words the packed span at (in ... in + nin) unpacks to, or '(size_t) -1' if
+// it does not start with a valid length, or is shorter than that length implies.
+DECI_API
+size_t deci_unpacked_nwords(const unsigned char *in, size_t nin);
+
+// Unpacks the packed span at (in ... in + nin) into 'out', which must have capacity of
+// 'deci_unpacked_nwords(in, nin)' words, and returns the number of bytes it took, so that packed
+// spans can be concatenated.
+//
+// Returns 0 if the input is not valid: if 'deci_unpacked_nwords()' would fail, if any of the words
+// is not less than 'DECI_BASE', if the most significant one is zero, or if the unused bits of the
+// last byte are not zero. In all but the first case, the contents of 'out' are unspecified.
+DECI_API
+size_t deci_unpack(const unsigned char *in, size_t nin, deci_UWORD *out);
+
+// Conversion from and to 'double'.
+//
+// Both assume that 'double' is the IEEE 754 binary64 format, with the same byte order as
+// 'uint64_t', and that the rounding mode is the default one (to nearest, ties to even).
+
+// The maximum number of words 'deci_from_double()' writes: the longest exact expansion of a double,
+// that of ((2^53 - 1) / 2^1074), has 767 significant digits.
+#define DECI_FROM_DOUBLE_NWORDS_MAX ((767 + DECI_BASE_LOG - 1) / DECI_BASE_LOG)
+
+// Converts the absolute value of 'x' exactly: writes an integer into (out ... out + N), where N is
+// the return value, and stores 'k' into '*scale', so that
+//     |x| = (out ... out + N) / 10^k.
+// 'k' is the smallest possible one, that is, (out ... out + N) is not divisible by 10 unless k = 0.
+// The result is normalized; for zero, N = 0 and k = 0.
+//
+// 'out' must have capacity of 'DECI_FROM_DOUBLE_NWORDS_MAX' words.
+//
+// Assumes that 'x' is finite; otherwise, the behavior is undefined.
+DECI_API
+size_t deci_from_double(double x, deci_UWORD *out, size_t *scale);
+
+// Returns the double nearest to (wa ... wa_end), with ties going to the even one, or positive
+// infinity if that is not less than 2^1024.
+//
+// Only the 19 most significant digits are read, unless the value is too close to the midpoint
+// between two doubles for them to tell which way to round; then the span is converted to binary
+// whole, which, as there are at most 309 digits to convert, is still a bounded amount of work.
+DECI_API
+double deci_to_double(deci_UWORD *wa, deci_UWORD *wa_end);
+
+// Resumable operations.
+//
+// The following are versions of long operations that can be run a bounded amount of work at a
+// time: '*_begin()' sets up a caller-owned state, and then each call of '*_step(state, budget)'
+// does at most 'budget' words of work (a word of work being about as much as 'deci_add()' does per
+// word) and returns whether the operation has finished. The spans passed to '*_begin()' must stay
+// valid, and must not be touched by anything else, until then. The fields of the states are not
+// to be accessed, except for the results as documented.
+//
+// '*_step()' assumes (budget > 0); otherwise, the behavior is undefined. Calling it after it has
+// returned true does nothing and returns true again.
+
+typedef struct {
+    deci_UWORD *wa, *wb;
+    size_t nwb;
+    deci_DOUBLE_UWORD b12;
+    deci_UWORD *r, *r_end;
+    int phase;
+    bool first_round;
+    size_t i;
+    deci_UWORD q;
+    deci_UWORD mul_carry;
+    bool carry;
+
+    // After 'deci_divmod_step()' has returned true: what 'deci_divmod_unsafe()' would return.
+    deci_UWORD qhi;
+} deci_DivmodState;
+
+// Same as 'deci_divmod_unsafe()', with the same assumptions, but resumable; takes
+// ((wa_end - wa) - (wb_end - wb) + 1) rounds of about (wb_end - wb) words of work each.
+DECI_API
+void deci_divmod_begin(
+        deci_DivmodState *st,
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end);
+
+DECI_API
+bool deci_divmod_step(deci_DivmodState *st, size_t budget);
+
+typedef struct {
+    deci_UWORD *wa, *wa_end;
+    deci_UWORD *wb, *wb_end;
+    deci_UWORD *out;
+    size_t i;
+    deci_UWORD mul_carry;
+    bool carry;
+} deci_MulState;
+
+// Same as 'deci_mul()', with the same assumptions, but resumable; takes (na * nb) words of work.
+DECI_API
+void deci_mul_begin(
+        deci_MulState *st,
+        deci_UWORD *wa, deci_UWORD *wa_end,
+        deci_UWORD *wb, deci_UWORD *wb_end,
+        deci_UWORD *out);
+
+DECI_API
+bool deci_mul_step(deci_MulState *st, size_t budget);
+
+typedef struct {
+    deci_UWORD *wa, *wa_end;
+    deci_UWORD *cur;
+    deci_UWORD carry;
+
+    // The number of words written into 'out' so far; after 'deci_tobits_step()' has returned
+    // true, of the whole result.
+    size_t nout;
+    deci_UWORD *out;
+} deci_TobitsState;
+
+// Converts (wa ... wa_end) to binary: repeats 'deci_tobits_round()' until (wa ... wa_end) is zero,
+// writing the remainders into 'out', which must have capacity of (wa_end - wa) words. The result
+// is normalized: it is the little-endian span of base (2 raised to 'DECI_WORD_BITS') digits of
+// the original value. Destroys (wa ... wa_end). Takes about (N * N / 2) words of work, where N is
+// the length of the normalized input.
+DECI_API
+void deci_tobits_begin(deci_TobitsState *st, deci_UWORD *wa, deci_UWORD *wa_end, deci_UWORD *out);
+
+DECI_API
+bool deci_tobits_step(deci_TobitsState *st, size_t budget);
+
+typedef struct {
+    const deci_UWORD *bits, *bits_end;
+    size_t i;
+    deci_UWORD carry;
+    bool in_pass;
+
+    // The number of words written into 'out' so far; after 'deci_frombits_step()' has returned
+    // true, of the whole result.
+    size_t nout;
+    deci_UWORD *out;
+} deci_FrombitsState;
+
+// Returns the capacity 'deci_frombits_begin()' needs for the output, given N binary words.
+static inline DECI_UNUSED
+size_t deci_frombits_nwords_max(size_t n)
+{
+    return n + n / 4 + 1;
+}
+
+// The inverse of 'deci_tobits_begin()': converts the little-endian span (bits ... bits_end) of
+// base (2 raised to 'DECI_WORD_BITS') digits to decimal, writing the normalized result into 'out',
+// which must have capacity of 'deci_frombits_nwords_max(bits_end - bits)' words. Takes about
+// (N * N / 2) words of work, where N is the length of the result.
+DECI_API
+void deci_frombits_begin(
+        deci_FrombitsState *st,
+        const deci_UWORD *bits, const deci_UWORD *bits_end,
+        deci_UWORD *out);
+
+DECI_API
+bool deci_frombits_step(deci_FrombitsState *st, size_t budget);
+
+// Statistics on the hot paths.
+//
+// If 'DECI_STATS' is defined to 1 when compiling 'deci.c', the library keeps per-thread counters of
+// calls into each of the non-inline functions above, of the number of rounds and add-back
+// corrections in long division, and of the lengths of carry/borrow tails in 'deci_add()' and
+// 'deci_sub_raw()'. Note that the calls the library makes internally are counted, too; for example,
+// 'deci_mul()' of an N-word span by an M-word one also counts as min(N, M) calls of
+// 'deci_add_scaled()'.
+//
+// If 'DECI_STATS' is not defined or is defined to 0, none of this is compiled in, and neither the
+// types nor the functions below are declared.
+
+#if ! defined(DECI_STATS)
+#   define DECI_STATS 0
+#endif
+
+#if DECI_STATS
+
+#define DECI_STATS_FOR_EACH_ENTRY(X) \
+    X(ADD, add) \
+    X(ADD_CHUNK, add_chunk) \
+    X(SUB_RAW, sub_raw) \
+    X(SUB_RAW_CHUNK, sub_raw_chunk) \
+    X(UNCOMPLEMENT, uncomplement) \
+    X(ABSDIFF, absdiff) \
+    X(ABSDIFF_OUT, absdiff_out) \
+    X(ADD_SCALED, add_scaled) \
+    X(SUB_SCALED_RAW, sub_scaled_raw) \
+    X(MUL, mul) \
+    X(MUL_INPLACE, mul_inplace) \
+    X(MULLO, mullo) \
+    X(MULLO_ADD, mullo_add) \
+    X(MULHI, mulhi) \
+    X(MULHI_EXACT, mulhi_exact) \
+    X(PROD_UWORDS, prod_uwords) \
+    X(FACTORIAL, factorial) \
+    X(BINOMIAL, binomial) \
+    X(MOD_UWORD_MULTI, mod_uword_multi) \
+    X(CRT, crt) \
+    X(DIVMOD_UNSAFE, divmod_unsafe) \
+    X(DIVMOD_DWORD, divmod_dword) \
+    X(DIVMOD_TWORD, divmod_tword) \
+    X(DIV, div) \
+    X(MOD, mod) \
+    X(DIVREM, divrem) \
+    X(DIV_APPR, div_appr) \
+    X(QUOTIENT, quotient) \
+    X(DIVEXACT_UWORD, divexact_uword) \
+    X(DIVEXACT, divexact) \
+    X(TOBITS_ROUND, tobits_round) \
+    X(TOLONG, tolong) \
+    X(LONG_TOBITS_ROUND, long_tobits_round) \
+    X(FROMBITS_ROUND, frombits_round) \
+    X(MUL_POW2, mul_pow2) \
+    X(DIVMOD_POW2, divmod_pow2) \
+    X(SHL10, shl10) \
+    X(SHR10, shr10) \
+    X(SHR10_ROUND, shr10_round) \
+    X(POW, pow) \
+    X(POW2, pow2) \
+    X(SQRTREM, sqrtrem) \
+    X(GCD, gcd) \
+    X(GCDEXT, gcdext) \
+    X(PACK, pack) \
+    X(UNPACK, unpack) \
+    X(FROM_DOUBLE, from_double) \
+    X(TO_DOUBLE, to_double) \
+    X(DIVMOD_STEP, divmod_step) \
+    X(MUL_STEP, mul_step) \
+    X(TOBITS_STEP, tobits_step) \
+    X(FROMBITS_STEP, frombits_step)
+
+typedef enum {
+#define DECI_X(Upper_, Lower_) DECI_STATS_##Upper_,
+    DECI_STATS_FOR_EACH_ENTRY(DECI_X)
+#undef DECI_X
+    DECI_STATS_NENTRIES
+} deci_StatsEntry;
+
+// Histograms have logarithmic buckets: bucket 0 counts the value of zero, and bucket i > 0 counts
+// values in [2^(i-1), 2^i); the last bucket also counts everything above its range.
+#define DECI_STATS_NBUCKETS 32
+
+typedef struct {
+    // Number of calls of each function.
+    uint64_t calls[DECI_STATS_NENTRIES];
+
+    // Total number of input words passed to each function; for functions with two span operands,
+    // the lengths of both are added together. For the '*_step()' functions, this is the number of
+    // words of work done, which is at most the budget.
+    uint64_t words[DECI_STATS_NENTRIES];
+
+    // Histogram of the number of input words (same as above) per call, for each function.
+    uint64_t sizes[DECI_STATS_NENTRIES][DECI_STATS_NBUCKETS];
+
+    // Number of quotient words computed by long division, and how many of them needed an add-back
+    // correction (that is, the estimate was one too large).
+    uint64_t div_rounds;
+    uint64_t div_corrections;
+
+    // Histograms of the number of words the carry in 'deci_add()', and the borrow in
+    // 'deci_sub_raw()', propagated past the end of the shorter operand.
+    uint64_t add_carry_tails[DECI_STATS_NBUCKETS];
+    uint64_t sub_borrow_tails[DECI_STATS_NBUCKETS];
+} deci_Stats;
+
+// Copies the counters of the calling thread into '*out'.
+DECI_API
+void deci_stats_snapshot(deci_Stats *out);
+
+// Zeroes out the counters of the calling thread.
+DECI_API
+void deci_stats_reset(void);
+
+// Returns the name of the function 'entry' stands for, without the "deci_" prefix.
+DECI_API
+const char *deci_stats_entry_name(deci_StatsEntry entry);
+
+#endif
+
 // Checks if (wa ... wa_end) represents the value of zero, i.e., that all its words are zero.
 static inline DECI_UNUSED DECI_FORCE_INLINE
 bool deci_is_zero(deci_UWORD *wa, deci_UWORD *wa_end)
@@ -503,3 +1431,11 @@ void deci_memmove(deci_UWORD *dst, const deci_UWORD *src, size_t n)
     else if (dst_i > src_i)
         deci_copy_backward(dst, src, n);
 }
+
+#if defined(__cplusplus) && ! DECI_HEADER_ONLY
+}
+#endif
+
+#if DECI_HEADER_ONLY && ! defined(DECI_C_)
+#   include "deci.c"
+#endif
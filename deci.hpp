@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "deci.h"
+
+// Compile-time decimal constants (C++14 or later).
+//
+// The '_deci' suffix turns an integer literal of any length into a 'deci::Constant', which holds
+// the words of its value in the layout of the current configuration (see 'DECI_WE_ARE_64_BIT' in
+// 'deci.h'):
+//
+//     using namespace deci::literals;
+//
+//     static constexpr auto P = 170141183460469231731687303715884105727_deci;
+//     ...
+//     size_t nr = deci_mod(wa, wa_end, P.begin(), P.end());
+//
+// The literal is converted by the compiler ('consteval' if supported, 'constexpr' otherwise), so
+// the words of a 'constexpr' constant are emitted as read-only data, and nothing is parsed at run
+// time. The span is normalized: it has no leading zero words, and '0_deci' is empty.
+//
+// Digit separators are allowed, as in '1'000'000_deci'. Any other literal -- hexadecimal, octal,
+// binary or floating-point -- is rejected at compile time.
+
+#if ! defined(DECI_CONSTEVAL)
+#   if defined(__cpp_consteval)
+#       define DECI_CONSTEVAL consteval
+#   else
+#       define DECI_CONSTEVAL constexpr
+#   endif
+#endif
+
+namespace deci {
+
+// A normalized span of 'N' words.
+template <size_t N>
+struct Constant {
+    // Arrays of zero size are not allowed, so there is always at least one word; only the first 'N'
+    // of them belong to the span.
+    deci_UWORD words[N ? N : 1];
+
+    static constexpr size_t size() { return N; }
+
+    // The 'deci_*' functions take non-const pointers to all the spans, including those they only
+    // read, so these are non-const too. Writing through them into a const (in particular, a
+    // 'constexpr') object is undefined behavior; copy the constant into a non-const one first.
+    deci_UWORD *begin() const { return const_cast<deci_UWORD *>(words); }
+    deci_UWORD *end() const { return begin() + N; }
+};
+
+namespace detail {
+
+constexpr bool literal_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Returns true if (s ... s + n) are the characters of a decimal integer literal.
+constexpr bool literal_valid(const char *s, size_t n)
+{
+    // A leading zero starts an octal, hexadecimal or binary literal, unless it is the only digit.
+    if (n == 0 || !literal_is_digit(s[0]) || (s[0] == '0' && n != 1))
+        return false;
+    for (size_t i = 1; i < n; ++i)
+        if (!literal_is_digit(s[i]) && s[i] != '\'')
+            return false;
+    return true;
+}
+
+// Returns the number of words in the normalized span of the literal (s ... s + n).
+constexpr size_t literal_nwords(const char *s, size_t n)
+{
+    size_t ndigits = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (literal_is_digit(s[i]) && (ndigits || s[i] != '0'))
+            ++ndigits;
+    return (ndigits + DECI_BASE_LOG - 1) / DECI_BASE_LOG;
+}
+
+// Converts the literal (s ... s + n), going from the least significant digit up.
+template <size_t N>
+constexpr Constant<N> literal_parse(const char *s, size_t n)
+{
+    Constant<N> r{};
+    size_t k = 0;
+    deci_UWORD tenpow = 1;
+    for (size_t i = n; i--;) {
+        if (!literal_is_digit(s[i]))
+            continue;
+        // The digits above the (N * DECI_BASE_LOG)-th one are all zeros.
+        if (k / DECI_BASE_LOG < N)
+            r.words[k / DECI_BASE_LOG] += static_cast<deci_UWORD>((s[i] - '0') * tenpow);
+        ++k;
+        tenpow = (k % DECI_BASE_LOG) ? static_cast<deci_UWORD>(tenpow * 10) : 1;
+    }
+    return r;
+}
+
+template <char... Cs>
+constexpr bool literal_valid()
+{
+    const char s[] = {Cs...};
+    return literal_valid(s, sizeof...(Cs));
+}
+
+template <char... Cs>
+constexpr size_t literal_nwords()
+{
+    const char s[] = {Cs...};
+    return literal_nwords(s, sizeof...(Cs));
+}
+
+} // namespace detail
+
+namespace literals {
+
+template <char... Cs>
+DECI_CONSTEVAL
+Constant<detail::literal_nwords<Cs...>()> operator""_deci()
+{
+    static_assert(detail::literal_valid<Cs...>(), "'_deci' requires a decimal integer literal");
+    const char s[] = {Cs...};
+    return detail::literal_parse<detail::literal_nwords<Cs...>()>(s, sizeof...(Cs));
+}
+
+} // namespace literals
+
+} // namespace deci
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "deci_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum { HEADER_SIZE = 16, FORMAT_VERSION = 1 };
+
+static const uint16_t BYTE_ORDER_MARK = 0x0102;
+
+typedef enum {
+    FORWARD,
+    BACKWARD,
+} Direction;
+
+static void encode_header(unsigned char *h, uint64_t nwords)
+{
+    memcpy(h, "DECI", 4);
+    h[4] = FORMAT_VERSION;
+    h[5] = sizeof(deci_UWORD);
+    memcpy(h + 6, &BYTE_ORDER_MARK, 2);
+    memcpy(h + 8, &nwords, 8);
+}
+
+static bool decode_header(const unsigned char *h, uint64_t *nwords)
+{
+    uint16_t mark;
+    memcpy(&mark, h + 6, 2);
+    if (memcmp(h, "DECI", 4) != 0 || h[4] != FORMAT_VERSION || h[5] != sizeof(deci_UWORD) ||
+        mark != BYTE_ORDER_MARK)
+    {
+        return false;
+    }
+    memcpy(nwords, h + 8, 8);
+    return true;
+}
+
+// Like 'pread()'/'pwrite()', but retries on short transfers and on 'EINTR'.
+
+static bool read_full(int fd, void *buf, size_t n, off_t offset)
+{
+    while (n) {
+        const ssize_t r = pread(fd, buf, n, offset);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (r == 0) {
+            errno = EINVAL;
+            return false;
+        }
+        buf = (unsigned char *) buf + r;
+        n -= r;
+        offset += r;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void *buf, size_t n, off_t offset)
+{
+    while (n) {
+        const ssize_t r = pwrite(fd, buf, n, offset);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        buf = (const unsigned char *) buf + r;
+        n -= r;
+        offset += r;
+    }
+    return true;
+}
+
+static bool file_size_ok(uint64_t nwords)
+{
+    const uint64_t max_off = ((uint64_t) 1 << (8 * sizeof(off_t) - 1)) - 1;
+    return nwords <= (max_off - HEADER_SIZE) / sizeof(deci_UWORD);
+}
+
+static void init_struct(deci_File *f, int fd, bool writable, uint64_t nwords)
+{
+    f->fd = fd;
+    f->writable = writable;
+    f->nwords = nwords;
+    f->window_words = DECI_FILE_WINDOW_WORDS;
+    f->map = NULL;
+    f->map_size = 0;
+}
+
+int deci_file_open(deci_File *f, const char *path, bool writable)
+{
+    const int fd = open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    unsigned char h[HEADER_SIZE];
+    uint64_t nwords;
+    struct stat st;
+    if (!read_full(fd, h, HEADER_SIZE, 0))
+        goto fail;
+    if (!decode_header(h, &nwords) || !file_size_ok(nwords))
+        goto invalid;
+    if (fstat(fd, &st) < 0)
+        goto fail;
+    if ((uint64_t) st.st_size < HEADER_SIZE + nwords * sizeof(deci_UWORD))
+        goto invalid;
+
+    init_struct(f, fd, writable, nwords);
+    return 0;
+
+invalid:
+    errno = EINVAL;
+fail:
+    {
+        const int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+    }
+    return -1;
+}
+
+int deci_file_create(deci_File *f, const char *path, uint64_t nwords)
+{
+    if (!file_size_ok(nwords)) {
+        errno = EFBIG;
+        return -1;
+    }
+
+    const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0)
+        return -1;
+
+    unsigned char h[HEADER_SIZE];
+    encode_header(h, nwords);
+    if (!write_full(fd, h, HEADER_SIZE, 0) ||
+        ftruncate(fd, HEADER_SIZE + nwords * sizeof(deci_UWORD)) < 0)
+    {
+        const int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+        return -1;
+    }
+
+    init_struct(f, fd, true, nwords);
+    return 0;
+}
+
+static bool unmap(deci_File *f)
+{
+    if (!f->map)
+        return true;
+    const int r = munmap(f->map, f->map_size);
+    f->map = NULL;
+    f->map_size = 0;
+    return r == 0;
+}
+
+int deci_file_close(deci_File *f)
+{
+    bool ok = unmap(f);
+    ok &= close(f->fd) == 0;
+    f->fd = -1;
+    return ok ? 0 : -1;
+}
+
+static deci_UWORD *map_window(deci_File *f, uint64_t start, size_t n, Direction dir)
+{
+    if (!unmap(f))
+        return NULL;
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+
+    const uint64_t begin = HEADER_SIZE + start * sizeof(deci_UWORD);
+    const uint64_t offset = begin - begin % page_size;
+    const size_t size = (begin - offset) + n * sizeof(deci_UWORD);
+
+    const int prot = PROT_READ | (f->writable ? PROT_WRITE : 0);
+    void *map = mmap(NULL, size, prot, MAP_SHARED, f->fd, offset);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    // Purely a hint, so the result is ignored. A window going forward is read front to back; one
+    // going backward is read back to front, which the kernel's read-ahead does not detect, so we
+    // ask it to prefetch the whole of it.
+    (void) posix_madvise(map, size, dir == FORWARD ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_WILLNEED);
+
+    f->map = map;
+    f->map_size = size;
+    return (deci_UWORD *) ((unsigned char *) map + (begin - offset));
+}
+
+deci_UWORD *deci_file_window(deci_File *f, uint64_t start, size_t n)
+{
+    return map_window(f, start, n, FORWARD);
+}
+
+static size_t min_window(deci_File *x, deci_File *y, deci_File *z)
+{
+    size_t w = x->window_words;
+    if (y && y->window_words < w)
+        w = y->window_words;
+    if (z && z->window_words < w)
+        w = z->window_words;
+    return w ? w : 1;
+}
+
+// Checks that 'out' can be written to and is not one of the inputs, setting 'errno' otherwise.
+static bool output_ok(deci_File *out, deci_File *a, deci_File *b)
+{
+    if (!out->writable) {
+        errno = EBADF;
+        return false;
+    }
+    if (out == a || out == b) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+static uint64_t min_u64(uint64_t x, uint64_t y)
+{
+    return x < y ? x : y;
+}
+
+// Maps the window (start ... start + n) of 'out', copies into it the part of 'a' that falls into
+// it, and zeroes out the rest. Returns NULL on failure.
+static deci_UWORD *load_window(deci_File *out, deci_File *a, uint64_t start, size_t n, Direction dir)
+{
+    deci_UWORD *o = map_window(out, start, n, dir);
+    if (!o)
+        return NULL;
+    const size_t na = start < a->nwords ? min_u64(n, a->nwords - start) : 0;
+    if (na) {
+        deci_UWORD *wa = map_window(a, start, na, dir);
+        if (!wa)
+            return NULL;
+        deci_memcpy(o, wa, na);
+    }
+    deci_zero_out_n(o + na, n - na);
+    return o;
+}
+
+// Maps the part of 'b' that falls into the window (start ... start + n), storing the resulting span
+// into (*wb ... *wb + *nb). If that part is empty, '*wb' is set to 'fallback' instead of mapping
+// anything. Returns false on failure.
+static bool map_overlap(
+        deci_File *b, uint64_t start, size_t n,
+        deci_UWORD *fallback, deci_UWORD **wb, size_t *nb)
+{
+    *nb = start < b->nwords ? min_u64(n, b->nwords - start) : 0;
+    *wb = *nb ? map_window(b, start, *nb, FORWARD) : fallback;
+    return *wb != NULL;
+}
+
+int deci_file_add(deci_File *out, deci_File *a, deci_File *b)
+{
+    if (!output_ok(out, a, b))
+        return -1;
+
+    const size_t w = min_window(out, a, b);
+    bool carry = false;
+    for (uint64_t start = 0; start < out->nwords; start += w) {
+        const size_t n = min_u64(w, out->nwords - start);
+        deci_UWORD *o = load_window(out, a, start, n, FORWARD);
+        if (!o)
+            return -1;
+        deci_UWORD *wb;
+        size_t nb;
+        if (!map_overlap(b, start, n, o, &wb, &nb))
+            return -1;
+        carry = deci_add_chunk(o, o + n, wb, wb + nb, carry);
+    }
+    return 0;
+}
+
+int deci_file_sub_raw(deci_File *out, deci_File *a, deci_File *b, bool *borrow)
+{
+    if (!output_ok(out, a, b))
+        return -1;
+
+    const size_t w = min_window(out, a, b);
+    bool br = false;
+    for (uint64_t start = 0; start < out->nwords; start += w) {
+        const size_t n = min_u64(w, out->nwords - start);
+        deci_UWORD *o = load_window(out, a, start, n, FORWARD);
+        if (!o)
+            return -1;
+        // The borrow must not propagate past the most significant word of 'a'.
+        const size_t nr = start < a->nwords ? min_u64(n, a->nwords - start) : 0;
+        deci_UWORD *wb;
+        size_t nb;
+        if (!map_overlap(b, start, n, o, &wb, &nb))
+            return -1;
+        br = deci_sub_raw_chunk(o, o + nr, wb, wb + nb, br);
+    }
+    *borrow = br;
+    return 0;
+}
+
+int deci_file_mul_uword(deci_File *out, deci_File *a, deci_UWORD y)
+{
+    if (!output_ok(out, a, NULL))
+        return -1;
+
+    const size_t w = min_window(out, a, NULL);
+    deci_UWORD carry = 0;
+    for (uint64_t start = 0; start < out->nwords; start += w) {
+        const size_t n = min_u64(w, out->nwords - start);
+        deci_UWORD *o = load_window(out, a, start, n, FORWARD);
+        if (!o)
+            return -1;
+        carry = deci_mul_uword_chunk(o, o + n, y, carry);
+    }
+    return 0;
+}
+
+int deci_file_divmod_uword(deci_File *out, deci_File *a, deci_UWORD y, deci_UWORD *rem)
+{
+    if (!output_ok(out, a, NULL))
+        return -1;
+
+    const size_t w = min_window(out, a, NULL);
+    deci_UWORD r = 0;
+    for (uint64_t end = out->nwords; end;) {
+        const size_t n = min_u64(w, end);
+        end -= n;
+        deci_UWORD *o = load_window(out, a, end, n, BACKWARD);
+        if (!o)
+            return -1;
+        r = deci_divmod_uword_chunk(o, o + n, y, r);
+    }
+    *rem = r;
+    return 0;
+}
+
+// Checks if the words (from ... to) of 'f' are all zero, going from the most significant one down.
+static int is_zero_range(deci_File *f, uint64_t from, uint64_t to, size_t w, bool *result)
+{
+    while (to > from) {
+        const size_t n = min_u64(w, to - from);
+        to -= n;
+        deci_UWORD *wf = map_window(f, to, n, BACKWARD);
+        if (!wf)
+            return -1;
+        if (!deci_is_zero_n(wf, n)) {
+            *result = false;
+            return 0;
+        }
+    }
+    *result = true;
+    return 0;
+}
+
+int deci_file_compare(deci_File *a, deci_File *b, int *result)
+{
+    if (a == b) {
+        *result = 0;
+        return 0;
+    }
+
+    const size_t w = min_window(a, b, NULL);
+
+    // Compare the excess words of the longer operand with zero first.
+    int sign = 1;
+    if (a->nwords < b->nwords) {
+        deci_File *t = a;
+        a = b;
+        b = t;
+        sign = -1;
+    }
+    bool zero;
+    if (is_zero_range(a, b->nwords, a->nwords, w, &zero) < 0)
+        return -1;
+    if (!zero) {
+        *result = sign;
+        return 0;
+    }
+
+    for (uint64_t end = b->nwords; end;) {
+        const size_t n = min_u64(w, end);
+        end -= n;
+        // Both windows have to stay mapped at once, so they are from different 'deci_File's.
+        deci_UWORD *wa = map_window(a, end, n, BACKWARD);
+        if (!wa)
+            return -1;
+        deci_UWORD *wb = map_window(b, end, n, BACKWARD);
+        if (!wb)
+            return -1;
+        const int c = deci_compare_n(wa, wb, n, -1, 0, 1);
+        if (c) {
+            *result = sign * c;
+            return 0;
+        }
+    }
+    *result = 0;
+    return 0;
+}
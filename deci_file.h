@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "deci.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Out-of-core arithmetic on spans stored in files (POSIX only).
+//
+// A span file consists of a 16-byte header followed by the words of the span, least significant
+// first, in the native byte order:
+//
+//     offset  size  contents
+//     0       4     magic: 'D', 'E', 'C', 'I'
+//     4       1     format version, currently 1
+//     5       1     sizeof(deci_UWORD), which determines the base
+//     6       2     the (uint16_t) value of 0x0102, to detect the byte order
+//     8       8     the (uint64_t) number of words
+//
+// Files written by a build with the other word size, or on a host with the other byte order, are
+// rejected.
+//
+// The 'deci_file_*' operations stream over their operands one window of 'window_words' words at
+// a time, passing the carry from one window to the next with the 'deci_*_chunk()' functions, so
+// that at most one window per operand is mapped at any time, however big the files are. Windows
+// are mapped with 'mmap()', with 'posix_madvise()' hints on the access pattern.
+//
+// All functions that can fail return 0 on success and -1 on failure, setting 'errno'. A header
+// that does not match is reported as 'EINVAL'.
+
+// See 'DECI_SYMBOL_PREFIX' in 'deci.h'.
+#if defined(DECI_SYMBOL_PREFIX)
+#   define deci_file_open         DECI_SYMBOL(file_open)
+#   define deci_file_create       DECI_SYMBOL(file_create)
+#   define deci_file_close        DECI_SYMBOL(file_close)
+#   define deci_file_window       DECI_SYMBOL(file_window)
+#   define deci_file_add          DECI_SYMBOL(file_add)
+#   define deci_file_sub_raw      DECI_SYMBOL(file_sub_raw)
+#   define deci_file_mul_uword    DECI_SYMBOL(file_mul_uword)
+#   define deci_file_divmod_uword DECI_SYMBOL(file_divmod_uword)
+#   define deci_file_compare      DECI_SYMBOL(file_compare)
+#endif
+
+// Default number of words mapped at a time.
+#if ! defined(DECI_FILE_WINDOW_WORDS)
+#   define DECI_FILE_WINDOW_WORDS ((size_t) 1 << 20)
+#endif
+
+typedef struct {
+    int fd;
+    bool writable;
+
+    // Number of words in the file.
+    uint64_t nwords;
+
+    // Number of words mapped at a time by the 'deci_file_*' operations; set to
+    // 'DECI_FILE_WINDOW_WORDS' when the file is opened, and may be changed afterwards.
+    size_t window_words;
+
+    // The current mapping, if any.
+    void *map;
+    size_t map_size;
+} deci_File;
+
+// Opens an existing span file, for reading and also for writing if 'writable' is true.
+int deci_file_open(deci_File *f, const char *path, bool writable);
+
+// Creates (or truncates) a span file of 'nwords' words, all of them zero, and opens it for reading
+// and writing. No disk space is allocated for the words until they are written to.
+int deci_file_create(deci_File *f, const char *path, uint64_t nwords);
+
+// Unmaps the current window and closes the file.
+int deci_file_close(deci_File *f);
+
+// Maps the words (start ... start + n) of the file, unmapping the previous window, and returns the
+// pointer to the first of them. The pointer is valid until the next call of this function or of
+// any 'deci_file_*' operation on this file, or until the file is closed. Writing through it is only
+// allowed if the file was opened as writable.
+//
+// Assumes (n > 0) and (start + n <= f->nwords); otherwise, the behavior is undefined.
+//
+// Returns NULL on failure.
+deci_UWORD *deci_file_window(deci_File *f, uint64_t start, size_t n);
+
+// The following operations take the output file separately from the input ones; it must be opened
+// as writable, must be a different file from all of them, and must have no fewer words than
+// specified. The words of the output that are higher than the result are zeroed out. An output
+// that is not writable is reported as 'EBADF', and one that is the same 'deci_File' as an input as
+// 'EINVAL'.
+
+// Writes the sum of 'a' and 'b' into 'out', of at least (max(na, nb) + 1) words.
+int deci_file_add(deci_File *out, deci_File *a, deci_File *b);
+
+// Same as 'deci_sub_raw()': subtracts 'b' from 'a', writing the result into 'out', of at least 'na'
+// words, and stores the borrow flag into '*borrow'. If it is true, the (na)-word ten's complement
+// of the result has been written.
+//
+// Assumes (na >= nb); otherwise, the behavior is undefined.
+int deci_file_sub_raw(deci_File *out, deci_File *a, deci_File *b, bool *borrow);
+
+// Writes the product of 'a' and 'y' into 'out', of at least (na + 1) words.
+//
+// Assumes (y < DECI_BASE); otherwise, the behavior is undefined.
+int deci_file_mul_uword(deci_File *out, deci_File *a, deci_UWORD y);
+
+// Writes the quotient of 'a' divided by 'y' into 'out', of at least 'na' words, and stores the
+// remainder into '*rem'. The windows are processed from the most significant one down.
+//
+// Assumes (0 < y < DECI_BASE); otherwise, the behavior is undefined.
+int deci_file_divmod_uword(deci_File *out, deci_File *a, deci_UWORD y, deci_UWORD *rem);
+
+// Compares 'a' and 'b', storing -1, 0, or 1 into '*result' if 'a' is less than, equal to, or
+// greater than 'b', respectively. Goes from the most significant words down and stops at the first
+// difference.
+int deci_file_compare(deci_File *a, deci_File *b, int *result);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "deci_regroup.h"
+
+// A block is 36 digits: 9 base-10^4 words, or 4 base-10^9 ones. Digit 'i' of the block is digit
+// (i % 4) of small word (i / 4), and digit (i % 9) of big word (i / 9); the big words thus take
+// the small words 0-1 and one digit of 2; three digits of 2, 3 and two digits of 4; two digits of
+// 4, 5 and three digits of 6; and one digit of 6, 7 and 8.
+
+enum { SMALL_PER_BLOCK = 9, BIG_PER_BLOCK = 4 };
+
+static inline void block_4to9(const uint16_t *s, uint32_t *b)
+{
+    b[0] = s[0] + s[1] * (uint32_t) 10000 + (s[2] % 10) * (uint32_t) 100000000;
+    b[1] = s[2] / 10 + s[3] * (uint32_t) 1000 + (s[4] % 100) * (uint32_t) 10000000;
+    b[2] = s[4] / 100 + s[5] * (uint32_t) 100 + (s[6] % 1000) * (uint32_t) 1000000;
+    b[3] = s[6] / 1000 + s[7] * (uint32_t) 10 + s[8] * (uint32_t) 100000;
+}
+
+static inline void block_9to4(const uint32_t *b, uint16_t *s)
+{
+    s[0] = b[0] % 10000;
+    s[1] = b[0] / 10000 % 10000;
+    s[2] = b[0] / 100000000 + (b[1] % 1000) * 10;
+    s[3] = b[1] / 1000 % 10000;
+    s[4] = b[1] / 10000000 + (b[2] % 100) * 100;
+    s[5] = b[2] / 100 % 10000;
+    s[6] = b[2] / 1000000 + (b[3] % 10) * 1000;
+    s[7] = b[3] / 10 % 10000;
+    s[8] = b[3] / 100000;
+}
+
+size_t deci_regroup_4to9(const uint16_t *in, size_t n, uint32_t *out)
+{
+    const size_t nblocks = n / SMALL_PER_BLOCK;
+    for (size_t i = 0; i < nblocks; ++i)
+        block_4to9(in + i * SMALL_PER_BLOCK, out + i * BIG_PER_BLOCK);
+
+    const size_t nrest = n % SMALL_PER_BLOCK;
+    size_t nout = nblocks * BIG_PER_BLOCK;
+    if (nrest) {
+        uint16_t s[SMALL_PER_BLOCK] = {0};
+        uint32_t b[BIG_PER_BLOCK];
+        for (size_t i = 0; i < nrest; ++i)
+            s[i] = in[nblocks * SMALL_PER_BLOCK + i];
+        block_4to9(s, b);
+        const size_t nb = (nrest * 4 + 8) / 9;
+        for (size_t i = 0; i < nb; ++i)
+            out[nout++] = b[i];
+    }
+
+    while (nout && !out[nout - 1])
+        --nout;
+    return nout;
+}
+
+size_t deci_regroup_9to4(const uint32_t *in, size_t n, uint16_t *out)
+{
+    const size_t nblocks = n / BIG_PER_BLOCK;
+    for (size_t i = 0; i < nblocks; ++i)
+        block_9to4(in + i * BIG_PER_BLOCK, out + i * SMALL_PER_BLOCK);
+
+    const size_t nrest = n % BIG_PER_BLOCK;
+    size_t nout = nblocks * SMALL_PER_BLOCK;
+    if (nrest) {
+        uint32_t b[BIG_PER_BLOCK] = {0};
+        uint16_t s[SMALL_PER_BLOCK];
+        for (size_t i = 0; i < nrest; ++i)
+            b[i] = in[nblocks * BIG_PER_BLOCK + i];
+        block_9to4(b, s);
+        const size_t ns = (nrest * 9 + 3) / 4;
+        for (size_t i = 0; i < ns; ++i)
+            out[nout++] = s[i];
+    }
+
+    while (nout && !out[nout - 1])
+        --nout;
+    return nout;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Conversion of spans between the two configurations (see 'DECI_WE_ARE_64_BIT' in 'deci.h'): the
+// base-10^4 one with 'uint16_t' words, and the base-10^9 one with 'uint32_t' words.
+//
+// Both bases are powers of ten, so this is just regrouping of the decimal digits: every 9 words of
+// the former hold the same 36 digits as every 4 words of the latter. It takes linear time and does
+// not go through strings.
+//
+// Unlike the rest of the library, this does not depend on the configuration, and so does not
+// include 'deci.h'; 'deci_regroup.c' is to be compiled once per binary, however many
+// configurations of the library it links (see 'DECI_SYMBOL_PREFIX' in 'deci.h').
+
+// Returns the number of words 'deci_regroup_4to9()' writes for an N-word input.
+static inline size_t deci_regroup_4to9_nout(size_t n)
+{
+    return (n / 9) * 4 + ((n % 9) * 4 + 8) / 9;
+}
+
+// Returns the number of words 'deci_regroup_9to4()' writes for an N-word input.
+static inline size_t deci_regroup_9to4_nout(size_t n)
+{
+    return (n / 4) * 9 + ((n % 4) * 9 + 3) / 4;
+}
+
+// Converts the base-10^4 span (in ... in + n) into base 10^9, writing 'deci_regroup_4to9_nout(n)'
+// words into 'out', which must not overlap with the input.
+//
+// Assumes all the input words are less than 10^4; otherwise, the behavior is undefined.
+//
+// Returns the number of words in the normalized result.
+size_t deci_regroup_4to9(const uint16_t *in, size_t n, uint32_t *out);
+
+// Converts the base-10^9 span (in ... in + n) into base 10^4, writing 'deci_regroup_9to4_nout(n)'
+// words into 'out', which must not overlap with the input.
+//
+// Assumes all the input words are less than 10^9; otherwise, the behavior is undefined.
+//
+// Returns the number of words in the normalized result.
+size_t deci_regroup_9to4(const uint32_t *in, size_t n, uint16_t *out);
+
+#if defined(__cplusplus)
+}
+#endif
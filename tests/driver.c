@@ -18,12 +18,16 @@
  */
 
 #define _POSIX_C_SOURCE 200809L
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <unistd.h>
 #include "../deci.h"
+#include "../deci_file.h"
+#include "../deci_regroup.h"
 
 #define SWAP(Type, X, Y) \
     do { \
@@ -92,6 +96,16 @@ static BigInt *bigint_alloc0(size_t size)
     return b;
 }
 
+// Truncates or zero-extends 'b' to 'n' words.
+static BigInt *bigint_resize_mod(BigInt *b, size_t n)
+{
+    const size_t old_size = b->size;
+    b = bigint_realloc(b, n);
+    if (n > old_size)
+        deci_zero_out_n(b->words + old_size, n - old_size);
+    return b;
+}
+
 static BigInt *bigint_push_word(BigInt *b, deci_UWORD w)
 {
     const size_t old_size = b->size;
@@ -190,6 +204,28 @@ static deci_UWORD x_read_word(void)
     return w;
 }
 
+static size_t x_read_size(void)
+{
+    char *s = x_read_line();
+    size_t n = 0;
+    for (const char *t = s; *t; ++t) {
+        if (*t < '0' || *t > '9') {
+            fprintf(stderr, "Expected digit, found '%c'\n", *t);
+            abort();
+        }
+        n = x_add_zu(x_mul_zu(n, 10), *t - '0');
+    }
+    free(s);
+    return n;
+}
+
+// Fills (w ... w + n) with garbage, which the function under test must not depend on.
+static void fill_garbage(deci_UWORD *w, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        w[i] = DECI_BASE - 1 - i % 7;
+}
+
 static void write_word(deci_UWORD w)
 {
     printf("%llu\n", (unsigned long long) w);
@@ -226,6 +262,38 @@ static void write_bigint(BigInt *b, bool negative)
     write_span(b->words, b->size, negative);
 }
 
+#if DECI_WE_ARE_64_BIT
+typedef uint16_t OtherWord;
+enum { OTHER_BASE_LOG = 4 };
+#   define regroup_to_other deci_regroup_9to4
+#   define regroup_to_other_nout deci_regroup_9to4_nout
+#   define regroup_from_other deci_regroup_4to9
+#   define regroup_from_other_nout deci_regroup_4to9_nout
+#else
+typedef uint32_t OtherWord;
+enum { OTHER_BASE_LOG = 9 };
+#   define regroup_to_other deci_regroup_4to9
+#   define regroup_to_other_nout deci_regroup_4to9_nout
+#   define regroup_from_other deci_regroup_9to4
+#   define regroup_from_other_nout deci_regroup_9to4_nout
+#endif
+
+// Writes a normalized span of the other configuration.
+static void write_other_span(const OtherWord *w, size_t n)
+{
+    if (!n) {
+        printf("0\n");
+        return;
+    }
+    --n;
+    printf("%llu", (unsigned long long) w[n]);
+    while (n) {
+        --n;
+        printf("%0*llu", (int) OTHER_BASE_LOG, (unsigned long long) w[n]);
+    }
+    printf("\n");
+}
+
 static void check_divisor_word(deci_UWORD w)
 {
     if (!w) {
@@ -243,6 +311,80 @@ static void check_divisor(BigInt *b, size_t min_size)
     }
 }
 
+static void check_size_le(BigInt *a, BigInt *b)
+{
+    if (a->size > b->size) {
+        fprintf(stderr, "Expected %zu-word number to be no longer than %zu-word one.\n",
+                a->size, b->size);
+        abort();
+    }
+}
+
+// The 'F' actions run the 'deci_file_*' operations on temporary span files, with windows this small
+// so that the operations cross many window boundaries.
+enum { FILE_WINDOW_WORDS = 2 };
+
+static void x_check_file_op(int r, const char *what)
+{
+    if (r < 0) {
+        perror(what);
+        abort();
+    }
+}
+
+static void x_check_file_op_rejected(int r, int expected_errno, const char *what)
+{
+    if (r != -1 || errno != expected_errno) {
+        fprintf(stderr, "Expected %s to fail with errno %d, got %d (errno %d).\n",
+                what, expected_errno, r, errno);
+        abort();
+    }
+}
+
+static void x_file_new(deci_File *f, uint64_t nwords)
+{
+    char path[] = "/tmp/deci_driver_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        abort();
+    }
+    close(fd);
+    x_check_file_op(deci_file_create(f, path, nwords), "deci_file_create");
+    unlink(path);
+    f->window_words = FILE_WINDOW_WORDS;
+}
+
+static void x_file_from_bigint(deci_File *f, BigInt *b)
+{
+    x_file_new(f, b->size);
+    for (size_t i = 0; i < b->size; i += FILE_WINDOW_WORDS) {
+        const size_t n = b->size - i < FILE_WINDOW_WORDS ? b->size - i : FILE_WINDOW_WORDS;
+        deci_UWORD *w = deci_file_window(f, i, n);
+        if (!w) {
+            perror("deci_file_window");
+            abort();
+        }
+        deci_memcpy(w, b->words + i, n);
+    }
+}
+
+static BigInt *x_file_to_bigint(deci_File *f)
+{
+    BigInt *b = bigint_alloc(f->nwords);
+    for (size_t i = 0; i < b->size; i += FILE_WINDOW_WORDS) {
+        const size_t n = b->size - i < FILE_WINDOW_WORDS ? b->size - i : FILE_WINDOW_WORDS;
+        deci_UWORD *w = deci_file_window(f, i, n);
+        if (!w) {
+            perror("deci_file_window");
+            abort();
+        }
+        deci_memcpy(b->words + i, w, n);
+    }
+    x_check_file_op(deci_file_close(f), "deci_file_close");
+    return b;
+}
+
 static bool interact(void)
 {
     char *action = x_read_line();
@@ -281,9 +423,35 @@ static bool interact(void)
                 neg = true;
             }
 
-            neg ^= deci_sub(
-                a->words, a->words + a->size,
-                b->words, b->words + b->size);
+            switch (action[1]) {
+            case '\0':
+                neg ^= deci_sub(
+                    a->words, a->words + a->size,
+                    b->words, b->words + b->size);
+                break;
+            case 'a':
+                neg ^= deci_absdiff(
+                    a->words, a->words + a->size,
+                    b->words, b->words + b->size);
+                break;
+            case 'o':
+                {
+                    // garbage in the output, which must all be overwritten
+                    BigInt *r = bigint_alloc(a->size);
+                    for (size_t i = 0; i < r->size; ++i)
+                        r->words[i] = DECI_BASE - 1 - i % 7;
+                    neg ^= deci_absdiff_out(
+                        a->words, a->words + a->size,
+                        b->words, b->words + b->size,
+                        r->words);
+                    SWAP(BigInt *, a, r);
+                    bigint_free(r);
+                }
+                break;
+            default:
+                fprintf(stderr, "First line starts with invalid sequence: '-%c'\n", action[1]);
+                return false;
+            }
             a->size = deci_normalize_n(a->words, a->size);
 
             write_bigint(a, neg);
@@ -336,6 +504,84 @@ static bool interact(void)
                 bigint_free(a);
             }
             break;
+        case 'x':
+            {
+                BigInt *a = x_read_bigint();
+                deci_UWORD b = x_read_word();
+
+                check_divisor_word(b);
+                deci_divexact_uword(a->words, a->words + a->size, b);
+                a->size = deci_normalize_n(a->words, a->size);
+
+                write_bigint(a, false);
+
+                bigint_free(a);
+            }
+            break;
+        case 'm':
+            {
+                BigInt *a = x_read_bigint();
+                const size_t k = x_read_word();
+                BigInt *divisors = bigint_alloc(k);
+                for (size_t i = 0; i < k; ++i) {
+                    divisors->words[i] = x_read_word();
+                    check_divisor_word(divisors->words[i]);
+                }
+                BigInt *out = bigint_alloc(k);
+
+                deci_mod_uword_multi(a->words, a->words + a->size, divisors->words, k, out->words);
+
+                for (size_t i = 0; i < k; ++i)
+                    write_word(out->words[i]);
+
+                bigint_free(a);
+                bigint_free(divisors);
+                bigint_free(out);
+            }
+            break;
+        case 'c':
+            {
+                const size_t k = x_read_word();
+                BigInt *moduli = bigint_alloc(k);
+                BigInt *residues = bigint_alloc(k);
+                for (size_t i = 0; i < k; ++i) {
+                    moduli->words[i] = x_read_word();
+                    check_divisor_word(moduli->words[i]);
+                }
+                for (size_t i = 0; i < k; ++i)
+                    residues->words[i] = x_read_word();
+                BigInt *out = bigint_alloc(k);
+
+                out->size = deci_crt(residues->words, moduli->words, k, out->words);
+
+                write_bigint(out, false);
+
+                bigint_free(moduli);
+                bigint_free(residues);
+                bigint_free(out);
+            }
+            break;
+        case 'p':
+            {
+                const size_t k = x_read_size();
+                BigInt *factors = bigint_alloc(k);
+                for (size_t i = 0; i < k; ++i)
+                    factors->words[i] = x_read_word();
+                const size_t cap = x_add_zu(k, 2);
+                BigInt *out = bigint_alloc(cap);
+                BigInt *scratch = bigint_alloc(cap);
+                fill_garbage(out->words, cap);
+                fill_garbage(scratch->words, cap);
+
+                out->size = deci_prod_uwords(factors->words, k, out->words, scratch->words);
+
+                write_bigint(out, false);
+
+                bigint_free(factors);
+                bigint_free(out);
+                bigint_free(scratch);
+            }
+            break;
         default:
             fprintf(stderr, "First line starts with invalid sequence: '1%c'\n", action[1]);
             return false;
@@ -361,6 +607,97 @@ static bool interact(void)
             bigint_free(r);
         }
         break;
+    case 'm':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            const size_t na = a->size;
+            const size_t nr = x_add_zu(na, b->size);
+            a = bigint_realloc(a, nr);
+            // garbage in the spare words, which must not matter
+            for (size_t i = na; i < nr; ++i)
+                a->words[i] = DECI_BASE - 1 - i % 7;
+
+            deci_mul_inplace(
+                a->words, a->words + na,
+                b->words, b->words + b->size);
+            a->size = deci_normalize_n(a->words, nr);
+
+            write_bigint(a, false);
+
+            bigint_free(a);
+            bigint_free(b);
+        }
+        break;
+    case 'L':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            BigInt *c = x_read_bigint();
+            const size_t n = x_read_word();
+            // the operands are taken modulo (DECI_BASE^n)
+            a = bigint_resize_mod(a, n);
+            b = bigint_resize_mod(b, n);
+            c = bigint_resize_mod(c, n);
+            BigInt *r = bigint_alloc(n);
+            for (size_t i = 0; i < n; ++i)
+                r->words[i] = DECI_BASE - 1 - i % 7;
+
+            deci_mullo(a->words, b->words, n, r->words);
+            r->size = deci_normalize_n(r->words, n);
+            write_bigint(r, false);
+
+            deci_mullo_add(a->words, b->words, c->words, n);
+            a->size = deci_normalize_n(a->words, n);
+            write_bigint(a, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(c);
+            bigint_free(r);
+        }
+        break;
+    case 'H':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            const size_t n = x_read_word();
+            if (n > a->size + b->size) {
+                fprintf(stderr, "Too many words wanted.\n");
+                abort();
+            }
+            const size_t nout = n + DECI_MULHI_GUARD;
+            const size_t k = a->size + b->size - n;
+            // garbage in the outputs and in the scratch, which must not matter
+            BigInt *r = bigint_alloc(nout);
+            BigInt *scratch = bigint_alloc(k);
+            for (size_t i = 0; i < nout; ++i)
+                r->words[i] = DECI_BASE - 1 - i % 7;
+            for (size_t i = 0; i < k; ++i)
+                scratch->words[i] = DECI_BASE - 1 - i % 5;
+
+            deci_mulhi(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                n, r->words);
+            r->size = deci_normalize_n(r->words, nout);
+            write_bigint(r, false);
+
+            for (size_t i = 0; i < nout; ++i)
+                r->words[i] = DECI_BASE - 1 - i % 7;
+            deci_mulhi_exact(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                n, r->words, scratch->words);
+            r->size = deci_normalize_n(r->words, n);
+            write_bigint(r, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(r);
+            bigint_free(scratch);
+        }
+        break;
     case 'd':
         {
             BigInt *a = x_read_bigint();
@@ -431,6 +768,85 @@ static bool interact(void)
             bigint_free(b);
         }
         break;
+    case 'D':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            check_divisor(b, 1);
+
+            BigInt *q = bigint_alloc(a->size);
+            BigInt *r = bigint_alloc(a->size);
+
+            q->size = deci_divrem(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                q->words,
+                r->words, &r->size);
+
+            // quotient
+            write_bigint(q, false);
+            // remainder
+            write_bigint(r, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(q);
+            bigint_free(r);
+        }
+        break;
+    case 'q':
+    case 'a':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            check_divisor(b, 1);
+
+            BigInt *q = bigint_alloc(a->size);
+            BigInt *scratch = bigint_alloc(x_mul_zu(2, a->size));
+
+            if (action[0] == 'q') {
+                q->size = deci_quotient(
+                    a->words, a->words + a->size,
+                    b->words, b->words + b->size,
+                    q->words,
+                    scratch->words);
+            } else {
+                q->size = deci_div_appr(
+                    a->words, a->words + a->size,
+                    b->words, b->words + b->size,
+                    q->words,
+                    scratch->words);
+            }
+
+            write_bigint(q, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(q);
+            bigint_free(scratch);
+        }
+        break;
+    case 'x':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            check_divisor(b, 1);
+
+            BigInt *scratch = bigint_alloc(b->size);
+
+            const size_t nr = deci_divexact(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                scratch->words);
+            a->size = deci_normalize_n(a->words, nr);
+
+            write_bigint(a, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(scratch);
+        }
+        break;
     case '?':
         {
             BigInt *a = x_read_bigint();
@@ -495,6 +911,523 @@ static bool interact(void)
             bigint_free(a);
         }
         break;
+    case 's':
+        {
+            BigInt *a = x_read_bigint();
+            const size_t na = a->size;
+            BigInt *s = bigint_alloc((na / 2) + (na % 2) + 1);
+
+            s->size = deci_sqrtrem(a->words, a->words + na, s->words);
+
+            // square root
+            write_bigint(s, false);
+            // remainder
+            write_bigint(a, false);
+
+            bigint_free(a);
+            bigint_free(s);
+        }
+        break;
+    case 'g':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+
+            if (a->size < b->size) {
+                SWAP(BigInt *, a, b);
+            }
+
+            BigInt *scratch = bigint_alloc(a->size);
+
+            a->size = deci_gcd(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                scratch->words);
+
+            write_bigint(a, false);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(scratch);
+        }
+        break;
+    case 'G':
+        {
+            BigInt *a = x_read_bigint();
+            BigInt *b = x_read_bigint();
+            check_size_le(b, a);
+
+            const size_t ns = b->size + 1;
+            BigInt *s = bigint_alloc(ns);
+            BigInt *scratch = bigint_alloc(x_add_zu(a->size, x_mul_zu(2, ns)));
+
+            bool s_negative;
+            a->size = deci_gcdext(
+                a->words, a->words + a->size,
+                b->words, b->words + b->size,
+                s->words, &s->size, &s_negative,
+                scratch->words);
+
+            // g
+            write_bigint(a, false);
+            // s
+            write_bigint(s, s_negative);
+
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(s);
+            bigint_free(scratch);
+        }
+        break;
+    case '<':
+        {
+            BigInt *a = x_read_bigint();
+            deci_UWORD k = x_read_word();
+
+            const size_t na = a->size;
+            const size_t nr = x_add_zu(na, k / DECI_BASE_LOG);
+            a = bigint_realloc(a, nr);
+            deci_zero_out(a->words + na, a->words + nr);
+
+            deci_UWORD hi = deci_shl10(a->words, a->words + nr, k);
+            a = bigint_push_word(a, hi);
+            a->size = deci_normalize_n(a->words, a->size);
+
+            write_bigint(a, false);
+
+            bigint_free(a);
+        }
+        break;
+    case '>':
+        {
+            BigInt *a = x_read_bigint();
+            deci_UWORD k = x_read_word();
+
+            const size_t nrem = (k / DECI_BASE_LOG) + !!(k % DECI_BASE_LOG);
+            BigInt *rem = bigint_alloc(nrem);
+
+            size_t nq;
+            switch (action[1]) {
+            case '\0':
+                nq = deci_shr10(a->words, a->words + a->size, k, rem->words);
+                break;
+            case 'h':
+                nq = deci_shr10_round(a->words, a->words + a->size, k, rem->words);
+                break;
+            default:
+                fprintf(stderr, "First line starts with invalid sequence: '>%c'\n", action[1]);
+                return false;
+            }
+            a->size = deci_normalize_n(a->words, nq);
+
+            // quotient
+            write_bigint(a, false);
+            // remainder
+            write_bigint(rem, false);
+
+            bigint_free(a);
+            bigint_free(rem);
+        }
+        break;
+    case '!':
+        {
+            const size_t n = x_read_size();
+            const size_t cap = deci_factorial_nwords_max(n);
+            BigInt *out = bigint_alloc(cap);
+            BigInt *scratch = bigint_alloc(cap);
+            fill_garbage(out->words, cap);
+            fill_garbage(scratch->words, cap);
+
+            out->size = deci_factorial(n, out->words, scratch->words);
+
+            write_bigint(out, false);
+
+            bigint_free(out);
+            bigint_free(scratch);
+        }
+        break;
+    case 'C':
+        {
+            const size_t n = x_read_size();
+            const size_t k = x_read_size();
+            const size_t cap = deci_binomial_nwords_max(n, k);
+            BigInt *out = bigint_alloc(cap);
+            BigInt *scratch = bigint_alloc(x_mul_zu(cap, 2));
+            fill_garbage(out->words, cap);
+            fill_garbage(scratch->words, 2 * cap);
+
+            out->size = deci_binomial(n, k, out->words, scratch->words);
+
+            write_bigint(out, false);
+
+            bigint_free(out);
+            bigint_free(scratch);
+        }
+        break;
+    case '^':
+        switch (action[1]) {
+        case '\0':
+            {
+                BigInt *a = x_read_bigint();
+                const size_t k = x_read_size();
+                // an extra zero word to check that the base is normalized
+                a = bigint_push_word(a, 0);
+
+                const size_t cap = deci_pow_nwords_max(deci_normalize_n(a->words, a->size), k);
+                BigInt *out = bigint_alloc(cap);
+                BigInt *scratch = bigint_alloc(cap);
+                fill_garbage(out->words, cap);
+                fill_garbage(scratch->words, cap);
+
+                out->size = deci_pow(a->words, a->words + a->size, k, out->words, scratch->words);
+
+                write_bigint(out, false);
+
+                bigint_free(a);
+                bigint_free(out);
+                bigint_free(scratch);
+            }
+            break;
+        case '2':
+            {
+                const size_t k = x_read_size();
+                const size_t cap = deci_pow2_nwords_max(k);
+                BigInt *out = bigint_alloc(cap);
+                BigInt *scratch = bigint_alloc(cap);
+                fill_garbage(out->words, cap);
+                fill_garbage(scratch->words, cap);
+
+                out->size = deci_pow2(k, out->words, scratch->words);
+
+                write_bigint(out, false);
+
+                bigint_free(out);
+                bigint_free(scratch);
+            }
+            break;
+        default:
+            fprintf(stderr, "First line starts with invalid sequence: '^%c'\n", action[1]);
+            return false;
+        }
+        break;
+    case 'b':
+        {
+            BigInt *a = x_read_bigint();
+            deci_UWORD k = x_read_word();
+
+            // (log10(2) < 0.31)
+            const size_t na = a->size;
+            const size_t nr = x_add_zu(na, k * (size_t) 31 / (100 * DECI_BASE_LOG));
+            a = bigint_realloc(a, nr);
+            deci_zero_out(a->words + na, a->words + nr);
+
+            deci_UWORD hi = deci_mul_pow2(a->words, a->words + nr, k);
+            a = bigint_push_word(a, hi);
+            a->size = deci_normalize_n(a->words, a->size);
+
+            write_bigint(a, false);
+
+            bigint_free(a);
+        }
+        break;
+    case 'B':
+        {
+            BigInt *a = x_read_bigint();
+            deci_UWORD k = x_read_word();
+
+            const size_t nrem = (k / DECI_WORD_BITS) + !!(k % DECI_WORD_BITS);
+            BigInt *rem = bigint_alloc(nrem);
+
+            const size_t nq = deci_divmod_pow2(a->words, a->words + a->size, k, rem->words);
+            a->size = deci_normalize_n(a->words, nq);
+
+            // quotient
+            write_bigint(a, false);
+            // remainder, in hex, as its words depend on the configuration
+            size_t i = nrem;
+            while (i && !rem->words[i - 1])
+                --i;
+            if (!i) {
+                printf("0\n");
+            } else {
+                --i;
+                printf("%llx", (unsigned long long) rem->words[i]);
+                while (i) {
+                    --i;
+                    printf("%0*llx", DECI_WORD_BITS / 4, (unsigned long long) rem->words[i]);
+                }
+                printf("\n");
+            }
+
+            bigint_free(a);
+            bigint_free(rem);
+        }
+        break;
+    case 'p':
+        {
+            BigInt *a = x_read_bigint();
+            // an extra zero word to check that the packed span is normalized
+            a = bigint_push_word(a, 0);
+
+            unsigned char *packed = x_realloc(NULL, 0, 1, deci_packed_size_max(a->size));
+            const size_t npacked = deci_pack(a->words, a->words + a->size, packed);
+
+            for (size_t i = 0; i < npacked; ++i)
+                printf("%02x", (unsigned) packed[i]);
+            printf("\n");
+
+            const size_t nwords = deci_unpacked_nwords(packed, npacked);
+            if (nwords == (size_t) -1 || deci_unpacked_nwords(packed, npacked - 1) != (size_t) -1) {
+                fprintf(stderr, "deci_unpacked_nwords() failed.\n");
+                abort();
+            }
+            BigInt *b = bigint_alloc(nwords);
+            if (deci_unpack(packed, npacked, b->words) != npacked) {
+                fprintf(stderr, "deci_unpack() failed.\n");
+                abort();
+            }
+
+            write_bigint(b, false);
+
+            free(packed);
+            bigint_free(a);
+            bigint_free(b);
+        }
+        break;
+    case 'r':
+        {
+            BigInt *a = x_read_bigint();
+
+            OtherWord *o = x_realloc(NULL, 0, sizeof(OtherWord), regroup_to_other_nout(a->size));
+            const size_t no = regroup_to_other(a->words, a->size, o);
+            write_other_span(o, no);
+
+            BigInt *b = bigint_alloc(regroup_from_other_nout(no));
+            const size_t nb = regroup_from_other(o, no, b->words);
+            b->size = nb;
+            write_bigint(b, false);
+
+            free(o);
+            bigint_free(a);
+            bigint_free(b);
+        }
+        break;
+    case 'e':
+        {
+            // the double is given in any form 'strtod()' takes; hex floats are exact
+            char *s = x_read_line();
+            char *s_end;
+            const double x = strtod(s, &s_end);
+            if (s_end == s || *s_end != '\0') {
+                fprintf(stderr, "Expected floating-point number, found '%s'.\n", s);
+                abort();
+            }
+            free(s);
+
+            BigInt *a = bigint_alloc(DECI_FROM_DOUBLE_NWORDS_MAX);
+            size_t scale;
+            a->size = deci_from_double(x, a->words, &scale);
+            write_bigint(a, false);
+            printf("%zu\n", scale);
+
+            bigint_free(a);
+        }
+        break;
+    case 'E':
+        {
+            BigInt *a = x_read_bigint();
+            printf("%a\n", deci_to_double(a->words, a->words + a->size));
+            bigint_free(a);
+        }
+        break;
+    case 'S':
+        switch (action[1]) {
+        case 'd':
+            {
+                BigInt *a = x_read_bigint();
+                BigInt *b = x_read_bigint();
+                check_divisor(b, 2);
+                const deci_UWORD budget = x_read_word();
+
+                if (a->size < b->size) {
+                    // quotient
+                    write_span(NULL, 0, false);
+                    // remainder
+                    write_bigint(a, false);
+
+                } else {
+                    deci_DivmodState st;
+                    deci_divmod_begin(&st, a->words, a->words + a->size, b->words, b->words + b->size);
+                    while (!deci_divmod_step(&st, budget)) {
+                    }
+
+                    a = bigint_push_word(a, st.qhi);
+
+                    // quotient
+                    write_span(a->words + b->size, a->size - b->size, false);
+                    // remainder
+                    write_span(a->words, b->size, false);
+                }
+
+                bigint_free(a);
+                bigint_free(b);
+            }
+            break;
+        case '*':
+            {
+                BigInt *a = x_read_bigint();
+                BigInt *b = x_read_bigint();
+                const deci_UWORD budget = x_read_word();
+                const size_t nr = x_add_zu(a->size, b->size);
+                BigInt *r = bigint_alloc0(nr);
+
+                deci_MulState st;
+                deci_mul_begin(&st, a->words, a->words + a->size, b->words, b->words + b->size, r->words);
+                while (!deci_mul_step(&st, budget)) {
+                }
+                r->size = deci_normalize_n(r->words, nr);
+
+                write_bigint(r, false);
+
+                bigint_free(a);
+                bigint_free(b);
+                bigint_free(r);
+            }
+            break;
+        case 't':
+            {
+                BigInt *a = x_read_bigint();
+                const deci_UWORD budget = x_read_word();
+                BigInt *bits = bigint_alloc(a->size);
+
+                deci_TobitsState st;
+                deci_tobits_begin(&st, a->words, a->words + a->size, bits->words);
+                while (!deci_tobits_step(&st, budget)) {
+                }
+
+                // same output as of 't'
+                if (!st.nout)
+                    write_word(0);
+                for (size_t i = 0; i < st.nout; ++i)
+                    write_word(bits->words[i]);
+
+                bigint_free(a);
+                bigint_free(bits);
+            }
+            break;
+        case 'f':
+            {
+                BigInt *a = x_read_bigint();
+                const deci_UWORD budget = x_read_word();
+                BigInt *bits = bigint_alloc(a->size);
+
+                deci_TobitsState st;
+                deci_tobits_begin(&st, a->words, a->words + a->size, bits->words);
+                while (!deci_tobits_step(&st, budget)) {
+                }
+                bits->size = st.nout;
+
+                BigInt *r = bigint_alloc(deci_frombits_nwords_max(bits->size));
+                deci_FrombitsState fst;
+                deci_frombits_begin(&fst, bits->words, bits->words + bits->size, r->words);
+                while (!deci_frombits_step(&fst, budget)) {
+                }
+                if (fst.nout && !r->words[fst.nout - 1]) {
+                    fprintf(stderr, "deci_frombits_step() gave a non-normalized result.\n");
+                    abort();
+                }
+                r->size = fst.nout;
+
+                write_bigint(r, false);
+
+                bigint_free(a);
+                bigint_free(bits);
+                bigint_free(r);
+            }
+            break;
+        default:
+            fprintf(stderr, "First line starts with invalid sequence: 'S%c'\n", action[1]);
+            return false;
+        }
+        break;
+    case 'F':
+        {
+            BigInt *a = x_read_bigint();
+            deci_File fa, fout;
+            x_file_from_bigint(&fa, a);
+
+            switch (action[1]) {
+            case '+':
+            case '-':
+            case '?':
+                {
+                    BigInt *b = x_read_bigint();
+                    deci_File fb;
+                    x_file_from_bigint(&fb, b);
+
+                    if (action[1] == '+') {
+                        x_check_file_op_rejected(deci_file_add(&fa, &fa, &fb), EINVAL, "deci_file_add");
+                        x_file_new(&fout, x_add_zu(a->size > b->size ? a->size : b->size, 1));
+                        x_check_file_op(deci_file_add(&fout, &fa, &fb), "deci_file_add");
+                        BigInt *r = x_file_to_bigint(&fout);
+                        write_bigint(r, false);
+                        bigint_free(r);
+
+                    } else if (action[1] == '-') {
+                        bool neg = a->size < b->size;
+                        deci_File *x = neg ? &fb : &fa;
+                        deci_File *y = neg ? &fa : &fb;
+                        x_file_new(&fout, x->nwords);
+                        bool borrow;
+                        x_check_file_op(deci_file_sub_raw(&fout, x, y, &borrow), "deci_file_sub_raw");
+                        BigInt *r = x_file_to_bigint(&fout);
+                        if (borrow)
+                            (void) deci_uncomplement(r->words, r->words + r->size);
+                        write_bigint(r, neg ^ borrow);
+                        bigint_free(r);
+
+                    } else {
+                        int c;
+                        x_check_file_op(deci_file_compare(&fa, &fb, &c), "deci_file_compare");
+                        printf("%c\n", c < 0 ? '<' : c > 0 ? '>' : '=');
+                    }
+
+                    x_check_file_op(deci_file_close(&fb), "deci_file_close");
+                    bigint_free(b);
+                }
+                break;
+            case '*':
+                {
+                    deci_UWORD y = x_read_word();
+                    x_file_new(&fout, x_add_zu(a->size, 1));
+                    x_check_file_op(deci_file_mul_uword(&fout, &fa, y), "deci_file_mul_uword");
+                    BigInt *r = x_file_to_bigint(&fout);
+                    write_bigint(r, false);
+                    bigint_free(r);
+                }
+                break;
+            case 'd':
+                {
+                    deci_UWORD y = x_read_word();
+                    check_divisor_word(y);
+                    x_file_new(&fout, a->size);
+                    deci_UWORD m;
+                    x_check_file_op(deci_file_divmod_uword(&fout, &fa, y, &m), "deci_file_divmod_uword");
+                    BigInt *r = x_file_to_bigint(&fout);
+                    write_bigint(r, false);
+                    write_word(m);
+                    bigint_free(r);
+                }
+                break;
+            default:
+                fprintf(stderr, "First line starts with invalid sequence: 'F%c'\n", action[1]);
+                return false;
+            }
+
+            x_check_file_op(deci_file_close(&fa), "deci_file_close");
+            bigint_free(a);
+        }
+        break;
     default:
         fprintf(stderr, "First line starts with invalid symbol: '%c'\n", action[0]);
         return false;
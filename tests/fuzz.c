@@ -0,0 +1,2868 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// In-process differential fuzzer: checks the 'deci_*' routines against a deliberately naive
+// reference bignum (one decimal digit per byte) on random and edge-case spans.
+//
+// Usage of the standalone build:
+//     fuzz [-n ITERATIONS] [-s SEED] [-S BASELINE_FILE] [-C BASELINE_FILE] [-T TOLERANCE_PERCENT]
+//
+// Runs ITERATIONS random checks (each one picks a routine at random), then, if '-S' is given,
+// times a fixed workload for every kernel and saves the timings into BASELINE_FILE; if '-C' is
+// given, times the same workload and fails if any kernel got more than TOLERANCE_PERCENT percent
+// slower than BASELINE_FILE says.
+//
+// With 'DECI_FUZZ_LIBFUZZER' defined to 1, the file instead provides 'LLVMFuzzerTestOneInput()';
+// the first byte of the input selects the routine, and the rest is used as the source of
+// "randomness" for generating the operands.
+//
+// If built with 'DECI_STATS' defined to 1, the standalone build also prints the library's hot-path
+// statistics gathered during the run.
+//
+// All spans are placed right before a poisoned guard area (and after a poisoned gap), so that
+// out-of-bounds writes are caught even without sanitizers.
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "../deci.h"
+#include "../deci_regroup.h"
+
+#if ! defined(DECI_FUZZ_LIBFUZZER)
+#   define DECI_FUZZ_LIBFUZZER 0
+#endif
+
+// Maximum length of an operand span, in words.
+enum { MAXW = 16 };
+
+// --- source of randomness -----------------------------------------------------------------
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static const uint8_t *src_data;
+static size_t src_size;
+
+static uint8_t src_byte(void)
+{
+    if (!src_size)
+        return 0;
+    --src_size;
+    return *src_data++;
+}
+
+static uint64_t rand_u64(void)
+{
+    if (DECI_FUZZ_LIBFUZZER) {
+        uint64_t r = 0;
+        for (int i = 0; i < 8; ++i)
+            r = (r << 8) | src_byte();
+        return r;
+    }
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Returns a value in [0; n).
+static size_t rand_below(size_t n)
+{
+    if (DECI_FUZZ_LIBFUZZER && n <= 256)
+        return src_byte() % n;
+    return rand_u64() % n;
+}
+
+// Returns a word, biased towards the interesting values.
+static deci_UWORD gen_word(void)
+{
+    switch (rand_below(8)) {
+    case 0:
+        return 0;
+    case 1:
+    case 2:
+        return DECI_BASE - 1;
+    case 3:
+        return 1;
+    case 4:
+        return DECI_BASE / 2;
+    default:
+        return rand_u64() % DECI_BASE;
+    }
+}
+
+static deci_UWORD gen_nonzero_word(void)
+{
+    const deci_UWORD w = gen_word();
+    return w ? w : 1 + rand_below(DECI_BASE - 1);
+}
+
+// Returns a length in [lo; hi], biased towards the bounds.
+static size_t gen_len(size_t lo, size_t hi)
+{
+    switch (rand_below(4)) {
+    case 0:
+        return lo;
+    case 1:
+        return hi;
+    default:
+        return lo + rand_below(hi - lo + 1);
+    }
+}
+
+static void gen_span(deci_UWORD *w, size_t n)
+{
+    switch (rand_below(6)) {
+    case 0:
+        for (size_t i = 0; i < n; ++i)
+            w[i] = DECI_BASE - 1;
+        break;
+    case 1:
+        for (size_t i = 0; i < n; ++i)
+            w[i] = DECI_BASE - 1;
+        if (n)
+            w[rand_below(n)] = rand_u64() % DECI_BASE;
+        break;
+    case 2:
+        for (size_t i = 0; i < n; ++i)
+            w[i] = rand_below(4) ? 0 : gen_word();
+        break;
+    case 3:
+        for (size_t i = 0; i < n; ++i)
+            w[i] = rand_u64() % DECI_BASE;
+        break;
+    default:
+        for (size_t i = 0; i < n; ++i)
+            w[i] = gen_word();
+        break;
+    }
+}
+
+// Same as 'gen_span()', but makes the most significant word non-zero.
+static void gen_normalized_span(deci_UWORD *w, size_t n)
+{
+    gen_span(w, n);
+    if (n && !w[n - 1])
+        w[n - 1] = gen_nonzero_word();
+}
+
+// --- reference bignum ---------------------------------------------------------------------
+
+enum { REF_CAP = 4 * MAXW * DECI_BASE_LOG + 64 };
+
+// Little-endian decimal digits; normalized, that is, (n == 0 || d[n - 1] != 0).
+typedef struct {
+    size_t n;
+    uint8_t d[REF_CAP];
+} Ref;
+
+static void ref_normalize(Ref *r)
+{
+    while (r->n && !r->d[r->n - 1])
+        --r->n;
+}
+
+static void ref_from_u64(Ref *r, uint64_t x)
+{
+    r->n = 0;
+    for (; x; x /= 10)
+        r->d[r->n++] = x % 10;
+}
+
+static void ref_from_digits(Ref *r, const uint64_t *w, size_t n, int ndigits)
+{
+    r->n = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t x = w[i];
+        for (int j = 0; j < ndigits; ++j) {
+            r->d[r->n++] = x % 10;
+            x /= 10;
+        }
+    }
+    ref_normalize(r);
+}
+
+static void ref_from_span(Ref *r, const deci_UWORD *w, size_t n)
+{
+    uint64_t tmp[4 * MAXW];
+    for (size_t i = 0; i < n; ++i)
+        tmp[i] = w[i];
+    ref_from_digits(r, tmp, n, DECI_BASE_LOG);
+}
+
+static void ref_from_long_span(Ref *r, const deci_DOUBLE_UWORD *w, size_t n)
+{
+    uint64_t tmp[4 * MAXW];
+    for (size_t i = 0; i < n; ++i)
+        tmp[i] = w[i];
+    ref_from_digits(r, tmp, n, 2 * DECI_BASE_LOG);
+}
+
+// Returns the number of words needed to represent 'r'.
+static size_t ref_nwords(const Ref *r)
+{
+    return (r->n + DECI_BASE_LOG - 1) / DECI_BASE_LOG;
+}
+
+// Writes 'r' into (w ... w + n); assumes it fits.
+static void ref_to_span(const Ref *r, deci_UWORD *w, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        deci_UWORD x = 0;
+        for (int j = DECI_BASE_LOG - 1; j >= 0; --j) {
+            const size_t k = i * DECI_BASE_LOG + j;
+            x = x * 10 + (k < r->n ? r->d[k] : 0);
+        }
+        w[i] = x;
+    }
+}
+
+static int ref_cmp(const Ref *a, const Ref *b)
+{
+    if (a->n != b->n)
+        return a->n < b->n ? -1 : 1;
+    for (size_t i = a->n; i--;)
+        if (a->d[i] != b->d[i])
+            return a->d[i] < b->d[i] ? -1 : 1;
+    return 0;
+}
+
+static uint8_t ref_digit(const Ref *r, size_t i)
+{
+    return i < r->n ? r->d[i] : 0;
+}
+
+// 'r' may alias 'a' or 'b'.
+static void ref_add(Ref *r, const Ref *a, const Ref *b)
+{
+    const size_t n = (a->n > b->n ? a->n : b->n) + 1;
+    int carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const int x = ref_digit(a, i) + ref_digit(b, i) + carry;
+        r->d[i] = x % 10;
+        carry = x / 10;
+    }
+    r->n = n;
+    ref_normalize(r);
+}
+
+// Assumes (a >= b). 'r' may alias 'a' or 'b'.
+static void ref_sub(Ref *r, const Ref *a, const Ref *b)
+{
+    const size_t n = a->n;
+    int borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int x = ref_digit(a, i) - ref_digit(b, i) - borrow;
+        borrow = x < 0;
+        r->d[i] = x + 10 * borrow;
+    }
+    r->n = n;
+    ref_normalize(r);
+}
+
+static void ref_mul(Ref *r, const Ref *a, const Ref *b)
+{
+    Ref t = {.n = a->n + b->n};
+    memset(t.d, 0, t.n);
+    for (size_t i = 0; i < a->n; ++i) {
+        int carry = 0;
+        for (size_t j = 0; j < b->n; ++j) {
+            const int x = t.d[i + j] + a->d[i] * b->d[j] + carry;
+            t.d[i + j] = x % 10;
+            carry = x / 10;
+        }
+        t.d[i + b->n] = carry;
+    }
+    ref_normalize(&t);
+    *r = t;
+}
+
+static void ref_mul_u64(Ref *r, const Ref *a, uint64_t x)
+{
+    Ref rx;
+    ref_from_u64(&rx, x);
+    ref_mul(r, a, &rx);
+}
+
+// Multiplies by (10 raised to 'k').
+static void ref_shl10(Ref *r, const Ref *a, size_t k)
+{
+    if (!a->n) {
+        r->n = 0;
+        return;
+    }
+    memmove(r->d + k, a->d, a->n);
+    memset(r->d, 0, k);
+    r->n = a->n + k;
+}
+
+static void ref_pow10(Ref *r, size_t k)
+{
+    Ref one;
+    ref_from_u64(&one, 1);
+    ref_shl10(r, &one, k);
+}
+
+// Multiplies 'r' by (2 raised to 'k').
+static void ref_mul_pow2(Ref *r, unsigned k)
+{
+    for (; k > 32; k -= 32)
+        ref_mul_u64(r, r, (uint64_t) 1 << 32);
+    ref_mul_u64(r, r, (uint64_t) 1 << k);
+}
+
+// Long division, one decimal digit at a time. Assumes 'b' is non-zero. Either 'q' or 'r' may be
+// NULL; neither may alias 'a' or 'b'.
+static void ref_divmod(Ref *q, Ref *r, const Ref *a, const Ref *b)
+{
+    Ref qq, rr;
+    qq.n = a->n;
+    rr.n = 0;
+    for (size_t i = a->n; i--;) {
+        // rr = rr * 10 + a->d[i]
+        memmove(rr.d + 1, rr.d, rr.n);
+        rr.d[0] = a->d[i];
+        ++rr.n;
+        ref_normalize(&rr);
+
+        uint8_t x = 0;
+        while (ref_cmp(&rr, b) >= 0) {
+            ref_sub(&rr, &rr, b);
+            ++x;
+        }
+        qq.d[i] = x;
+    }
+    ref_normalize(&qq);
+    if (q)
+        *q = qq;
+    if (r)
+        *r = rr;
+}
+
+static void ref_gcd(Ref *g, const Ref *a, const Ref *b)
+{
+    Ref x = *a;
+    Ref y = *b;
+    while (y.n) {
+        Ref t;
+        ref_divmod(NULL, &t, &x, &y);
+        x = y;
+        y = t;
+    }
+    *g = x;
+}
+
+static bool ref_is_odd(const Ref *r)
+{
+    return r->n && (r->d[0] & 1);
+}
+
+static void ref_print(FILE *f, const Ref *r)
+{
+    if (!r->n)
+        fputc('0', f);
+    for (size_t i = r->n; i--;)
+        fputc('0' + r->d[i], f);
+}
+
+// --- failure reporting --------------------------------------------------------------------
+
+static const char *cur_op;
+static uint64_t cur_iter;
+static uint64_t cur_seed;
+
+typedef struct {
+    const char *name;
+    size_t n;
+    deci_UWORD w[4 * MAXW];
+} Note;
+
+static Note notes[4];
+static size_t nnotes;
+
+static void note(const char *name, const deci_UWORD *w, size_t n)
+{
+    Note *x = &notes[nnotes++];
+    x->name = name;
+    x->n = n;
+    memcpy(x->w, w, n * sizeof(deci_UWORD));
+}
+
+static void note_word(const char *name, uint64_t v)
+{
+    const deci_UWORD w[2] = {(deci_UWORD) (v % DECI_BASE), (deci_UWORD) (v / DECI_BASE)};
+    note(name, w, v / DECI_BASE ? 2 : 1);
+}
+
+static void fail(int line, const char *what)
+{
+    fprintf(stderr, "FAILED: %s (line %d): %s\n", cur_op, line, what);
+    if (!DECI_FUZZ_LIBFUZZER)
+        fprintf(stderr, "  seed %llu, iteration %llu\n",
+                (unsigned long long) cur_seed, (unsigned long long) cur_iter);
+    for (size_t i = 0; i < nnotes; ++i) {
+        fprintf(stderr, "  %s (%zu words, most significant first):", notes[i].name, notes[i].n);
+        for (size_t j = notes[i].n; j--;)
+            fprintf(stderr, " %llu", (unsigned long long) notes[i].w[j]);
+        Ref r;
+        ref_from_span(&r, notes[i].w, notes[i].n);
+        fputs("\n    = ", stderr);
+        ref_print(stderr, &r);
+        fputc('\n', stderr);
+    }
+    abort();
+}
+
+#define CHECK(Cond) \
+    do { \
+        if (!(Cond)) \
+            fail(__LINE__, #Cond); \
+    } while (0)
+
+// Converts the result span (w ... w + n) to 'r', checking that all its words are valid.
+static void get(Ref *r, const deci_UWORD *w, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        CHECK(w[i] < DECI_BASE);
+    ref_from_span(r, w, n);
+}
+
+static bool ref_eq(const Ref *a, const Ref *b)
+{
+    return ref_cmp(a, b) == 0;
+}
+
+// --- guarded buffers ----------------------------------------------------------------------
+
+enum { GUARD = 4, BUF_CAP = 4 * MAXW + 8 };
+
+static const deci_UWORD POISON = (deci_UWORD) -1;
+
+typedef struct {
+    deci_UWORD w[GUARD + BUF_CAP + GUARD];
+    deci_UWORD *p;
+    size_t cap;
+} Buf;
+
+// Returns a span of capacity 'cap' with everything around it poisoned.
+static deci_UWORD *buf_place(Buf *b, size_t cap)
+{
+    for (size_t i = 0; i < GUARD + BUF_CAP + GUARD; ++i)
+        b->w[i] = POISON;
+    b->cap = cap;
+    b->p = b->w + GUARD + BUF_CAP - cap;
+    return b->p;
+}
+
+// Checks that nothing outside of the span was written to.
+static void buf_check(const Buf *b)
+{
+    for (const deci_UWORD *x = b->w; x != b->p; ++x)
+        CHECK(*x == POISON);
+    for (const deci_UWORD *x = b->p + b->cap; x != b->w + GUARD + BUF_CAP + GUARD; ++x)
+        CHECK(*x == POISON);
+}
+
+static Buf buf_a, buf_b, buf_c, buf_d;
+
+// --- checks -------------------------------------------------------------------------------
+
+static void check_add(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, na);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(a, na);
+    gen_span(b, nb);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, want, got, x;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_add(&want, &ra, &rb);
+
+    const bool carry = deci_add(a, a + na, b, b + nb);
+    get(&got, a, na);
+    if (carry) {
+        ref_pow10(&x, na * DECI_BASE_LOG);
+        ref_add(&got, &got, &x);
+    }
+    CHECK(ref_eq(&got, &want));
+    get(&x, b, nb);
+    CHECK(ref_eq(&x, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_sub(bool raw)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, na);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(a, na);
+    gen_span(b, nb);
+    if (nb && rand_below(4) == 0)
+        // Make the operands close to each other.
+        memcpy(a, b, nb * sizeof(deci_UWORD));
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, got, x;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    const bool less = ref_cmp(&ra, &rb) < 0;
+
+    const bool borrow = raw
+        ? deci_sub_raw(a, a + na, b, b + nb)
+        : deci_sub(a, a + na, b, b + nb);
+    CHECK(borrow == less);
+    get(&got, a, na);
+    if (!borrow) {
+        ref_sub(&x, &ra, &rb);
+    } else if (raw) {
+        // got == B^na + a - b
+        ref_add(&got, &got, &rb);
+        ref_pow10(&x, na * DECI_BASE_LOG);
+        ref_add(&x, &x, &ra);
+    } else {
+        ref_sub(&x, &rb, &ra);
+    }
+    CHECK(ref_eq(&got, &x));
+    get(&x, b, nb);
+    CHECK(ref_eq(&x, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_sub_raw(void)
+{
+    check_sub(true);
+}
+
+static void check_sub_abs(void)
+{
+    check_sub(false);
+}
+
+// Checks the '*_chunk()' functions by doing an operation over randomly split chunks and comparing
+// the result with that of the corresponding whole-span function.
+static void check_absdiff(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, na);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    // 'b' gets the capacity of 'a', in case the result is written over it.
+    deci_UWORD *b = buf_place(&buf_b, na);
+    gen_span(a, na);
+    gen_span(b, nb);
+    if (nb && rand_below(2)) {
+        // Make the operands equal but for a word, so that the comparison may go far down.
+        memcpy(b, a, nb * sizeof(deci_UWORD));
+        b[rand_below(nb)] = gen_word();
+    }
+    if (rand_below(2))
+        deci_zero_out_n(a + nb, na - nb);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, got, x;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    const bool less = ref_cmp(&ra, &rb) < 0;
+    if (less)
+        ref_sub(&x, &rb, &ra);
+    else
+        ref_sub(&x, &ra, &rb);
+
+    deci_UWORD *out;
+    bool r;
+    switch (rand_below(4)) {
+    case 0:
+        out = a;
+        r = deci_absdiff(a, a + na, b, b + nb);
+        break;
+    case 1:
+        out = buf_place(&buf_c, na);
+        gen_span(out, na);
+        r = deci_absdiff_out(a, a + na, b, b + nb, out);
+        get(&got, a, na);
+        CHECK(ref_eq(&got, &ra));
+        get(&got, b, nb);
+        CHECK(ref_eq(&got, &rb));
+        buf_check(&buf_c);
+        break;
+    case 2:
+        out = a;
+        r = deci_absdiff_out(a, a + na, b, b + nb, out);
+        get(&got, b, nb);
+        CHECK(ref_eq(&got, &rb));
+        break;
+    default:
+        out = b;
+        r = deci_absdiff_out(a, a + na, b, b + nb, out);
+        get(&got, a, na);
+        CHECK(ref_eq(&got, &ra));
+        break;
+    }
+    CHECK(r == less);
+    get(&got, out, na);
+    CHECK(ref_eq(&got, &x));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_chunks(void)
+{
+    const size_t op = rand_below(4);
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = op < 2 ? gen_len(0, na) : 0;
+    deci_UWORD *a = buf_place(&buf_a, na);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    deci_UWORD *whole = buf_place(&buf_c, na);
+    gen_span(a, na);
+    gen_span(b, nb);
+    const deci_UWORD y = op == 3 ? gen_nonzero_word() : gen_word();
+    memcpy(whole, a, na * sizeof(deci_UWORD));
+    note("a", a, na);
+    note("b", b, nb);
+    note_word("op", op);
+    note_word("y", y);
+
+    deci_UWORD want = 0;
+    switch (op) {
+    case 0:
+        want = deci_add(whole, whole + na, b, b + nb);
+        break;
+    case 1:
+        want = deci_sub_raw(whole, whole + na, b, b + nb);
+        break;
+    case 2:
+        want = deci_mul_uword(whole, whole + na, y);
+        break;
+    case 3:
+        want = deci_divmod_uword(whole, whole + na, y);
+        break;
+    }
+
+    deci_UWORD got = 0;
+    if (op == 3) {
+        for (size_t end = na; end;) {
+            const size_t start = end - gen_len(0, end);
+            got = deci_divmod_uword_chunk(a + start, a + end, y, got);
+            end = start;
+        }
+    } else {
+        for (size_t start = 0; start != na;) {
+            const size_t end = start + gen_len(0, na - start);
+            deci_UWORD *wb = b + (start < nb ? start : nb);
+            deci_UWORD *wb_end = b + (end < nb ? end : nb);
+            switch (op) {
+            case 0:
+                got = deci_add_chunk(a + start, a + end, wb, wb_end, got);
+                break;
+            case 1:
+                got = deci_sub_raw_chunk(a + start, a + end, wb, wb_end, got);
+                break;
+            case 2:
+                got = deci_mul_uword_chunk(a + start, a + end, y, got);
+                break;
+            }
+            start = end;
+        }
+    }
+    CHECK(got == want);
+    CHECK(na == 0 || memcmp(a, whole, na * sizeof(deci_UWORD)) == 0);
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_uncomplement(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+
+    Ref ra, got, x;
+    ref_from_span(&ra, a, n);
+
+    const bool r = deci_uncomplement(a, a + n);
+    CHECK(r == (ra.n != 0));
+    get(&got, a, n);
+    if (r) {
+        ref_pow10(&x, n * DECI_BASE_LOG);
+        ref_sub(&x, &x, &ra);
+        CHECK(ref_eq(&got, &x));
+    } else {
+        CHECK(got.n == 0);
+    }
+    buf_check(&buf_a);
+}
+
+static void check_mul_uword(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    const deci_UWORD y = gen_word();
+    note("a", a, n);
+    note_word("y", y);
+
+    Ref ra, want, got, x;
+    ref_from_span(&ra, a, n);
+    ref_mul_u64(&want, &ra, y);
+
+    const deci_UWORD carry = deci_mul_uword(a, a + n, y);
+    CHECK(carry < DECI_BASE);
+    get(&got, a, n);
+    ref_from_u64(&x, carry);
+    ref_shl10(&x, &x, n * DECI_BASE_LOG);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+}
+
+static void check_add_scaled(void)
+{
+    const size_t nz = gen_len(0, MAXW);
+    // (x < B^(nx - 1)) and (z * y < B^(nz + 1)), so the sum fits into 'nx' words.
+    const size_t nx = nz + 2 + rand_below(2);
+    deci_UWORD *wx = buf_place(&buf_a, nx);
+    deci_UWORD *wz = buf_place(&buf_b, nz);
+    gen_span(wx, nx - 1);
+    wx[nx - 1] = 0;
+    gen_span(wz, nz);
+    const deci_UWORD y = gen_word();
+    note("x", wx, nx);
+    note("z", wz, nz);
+    note_word("y", y);
+
+    Ref rx, rz, want, got;
+    ref_from_span(&rx, wx, nx);
+    ref_from_span(&rz, wz, nz);
+    ref_mul_u64(&want, &rz, y);
+    ref_add(&want, &want, &rx);
+
+    deci_add_scaled(wx, y, wz, wz + nz);
+    get(&got, wx, nx);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_sub_scaled_raw(void)
+{
+    const size_t nx = gen_len(0, MAXW);
+    const size_t nz = gen_len(0, nx);
+    deci_UWORD *wx = buf_place(&buf_a, nx);
+    deci_UWORD *wz = buf_place(&buf_b, nz);
+    gen_span(wx, nx);
+    gen_span(wz, nz);
+    const deci_UWORD y = gen_word();
+    note("x", wx, nx);
+    note("z", wz, nz);
+    note_word("y", y);
+
+    Ref rx, rz, lhs, rhs, x;
+    ref_from_span(&rx, wx, nx);
+    ref_from_span(&rz, wz, nz);
+
+    const deci_UWORD borrow = deci_sub_scaled_raw(wx, wx + nx, y, wz, wz + nz);
+    // x - z * y == result - borrow * B^nx
+    get(&lhs, wx, nx);
+    ref_mul_u64(&x, &rz, y);
+    ref_add(&lhs, &lhs, &x);
+    ref_from_u64(&rhs, borrow);
+    ref_shl10(&rhs, &rhs, nx * DECI_BASE_LOG);
+    ref_add(&rhs, &rhs, &rx);
+    CHECK(ref_eq(&lhs, &rhs));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_mul(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    deci_UWORD *out = buf_place(&buf_c, na + nb);
+    gen_span(a, na);
+    gen_span(b, nb);
+    deci_zero_out_n(out, na + nb);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, want, got, x;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_mul(&want, &ra, &rb);
+
+    deci_mul(a, a + na, b, b + nb, out);
+    get(&got, out, na + nb);
+    CHECK(ref_eq(&got, &want));
+    get(&x, a, na);
+    CHECK(ref_eq(&x, &ra));
+    get(&x, b, nb);
+    CHECK(ref_eq(&x, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_mul_inplace(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, na + nb);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(a, na + nb);
+    gen_span(b, nb);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, want, got;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_mul(&want, &ra, &rb);
+
+    deci_mul_inplace(a, a + na, b, b + nb);
+    get(&got, a, na + nb);
+    CHECK(ref_eq(&got, &want));
+    get(&got, b, nb);
+    CHECK(ref_eq(&got, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+// Checks 'deci_mullo()', with the output separate from the operands or in place of either of them,
+// and 'deci_mullo_add()'.
+static void check_mullo(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    deci_UWORD *b = buf_place(&buf_b, n);
+    deci_UWORD *c = buf_place(&buf_c, n);
+    gen_span(a, n);
+    gen_span(b, n);
+    gen_span(c, n);
+    note("a", a, n);
+    note("b", b, n);
+    note("c", c, n);
+
+    Ref ra, rb, rc, modulus, want, want_add, x, got;
+    ref_from_span(&ra, a, n);
+    ref_from_span(&rb, b, n);
+    ref_from_span(&rc, c, n);
+    ref_pow10(&modulus, n * DECI_BASE_LOG);
+    ref_mul(&x, &ra, &rb);
+    ref_divmod(&got, &want, &x, &modulus);
+    ref_add(&x, &x, &rc);
+    ref_divmod(&got, &want_add, &x, &modulus);
+
+    deci_UWORD *out;
+    switch (rand_below(3)) {
+    case 0:
+        out = buf_place(&buf_d, n);
+        gen_span(out, n);
+        deci_mullo(a, b, n, out);
+        get(&got, a, n);
+        CHECK(ref_eq(&got, &ra));
+        get(&got, b, n);
+        CHECK(ref_eq(&got, &rb));
+        buf_check(&buf_d);
+        break;
+    case 1:
+        out = a;
+        deci_mullo(a, b, n, out);
+        get(&got, b, n);
+        CHECK(ref_eq(&got, &rb));
+        break;
+    default:
+        out = b;
+        deci_mullo(a, b, n, out);
+        get(&got, a, n);
+        CHECK(ref_eq(&got, &ra));
+        break;
+    }
+    get(&got, out, n);
+    CHECK(ref_eq(&got, &want));
+
+    // Restore the operands for 'deci_mullo_add()'.
+    ref_to_span(&ra, a, n);
+    ref_to_span(&rb, b, n);
+    deci_mullo_add(a, b, c, n);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &want_add));
+    get(&got, b, n);
+    CHECK(ref_eq(&got, &rb));
+    get(&got, c, n);
+    CHECK(ref_eq(&got, &rc));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+// Checks 'deci_mulhi()' and 'deci_mulhi_exact()'. Sometimes 'b' is chosen so that the product is
+// just above a multiple of DECI_BASE^K, which is where the guard words overflow into the result.
+static void check_mulhi(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    size_t nb = gen_len(0, MAXW);
+    const size_t n = gen_len(0, na + nb);
+    const size_t k = na + nb - n;
+    deci_UWORD *a = buf_place(&buf_a, na);
+    gen_span(a, na);
+    Ref ra, rb, p, x, y, want, got;
+    ref_from_span(&ra, a, na);
+
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(b, nb);
+    if (n && ra.n && rand_below(4) == 0) {
+        // b = ceil(c B^K / a) for a random n-word 'c'.
+        deci_UWORD wc[2 * MAXW];
+        gen_span(wc, n);
+        ref_from_span(&x, wc, n);
+        ref_shl10(&x, &x, k * DECI_BASE_LOG);
+        ref_add(&x, &x, &ra);
+        ref_from_u64(&y, 1);
+        ref_sub(&x, &x, &y);
+        ref_divmod(&rb, &y, &x, &ra);
+        if (ref_nwords(&rb) <= nb)
+            ref_to_span(&rb, b, nb);
+    }
+    note("a", a, na);
+    note("b", b, nb);
+    note_word("n", n);
+
+    ref_from_span(&rb, b, nb);
+    ref_mul(&p, &ra, &rb);
+
+    deci_UWORD *out = buf_place(&buf_c, n + DECI_MULHI_GUARD);
+    deci_mulhi(a, a + na, b, b + nb, n, out);
+    get(&got, out, n + DECI_MULHI_GUARD);
+    if (k >= DECI_MULHI_GUARD) {
+        // got <= floor(P / B^T) < got + m B
+        const size_t t = k - DECI_MULHI_GUARD;
+        ref_pow10(&x, t * DECI_BASE_LOG);
+        ref_divmod(&want, &y, &p, &x);
+        const size_t m = na < nb ? na : nb;
+        CHECK(ref_cmp(&got, &want) <= 0);
+        ref_from_u64(&y, (uint64_t) m * DECI_BASE);
+        ref_add(&x, &got, &y);
+        CHECK(m == 0 || ref_cmp(&want, &x) < 0);
+    } else {
+        ref_shl10(&want, &p, (DECI_MULHI_GUARD - k) * DECI_BASE_LOG);
+        CHECK(ref_eq(&got, &want));
+    }
+    buf_check(&buf_c);
+
+    out = buf_place(&buf_c, n + DECI_MULHI_GUARD);
+    deci_UWORD *scratch = buf_place(&buf_d, k);
+    deci_mulhi_exact(a, a + na, b, b + nb, n, out, scratch);
+    get(&got, out, n);
+    ref_pow10(&x, k * DECI_BASE_LOG);
+    ref_divmod(&want, &y, &p, &x);
+    CHECK(ref_eq(&got, &want));
+
+    get(&got, a, na);
+    CHECK(ref_eq(&got, &ra));
+    get(&got, b, nb);
+    CHECK(ref_eq(&got, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+// Returns a divisor of DECI_BASE, less than it; products of these hit DECI_BASE^2 exactly.
+static deci_UWORD gen_base_divisor(void)
+{
+    deci_UWORD x = 1;
+    for (size_t i = rand_below(DECI_BASE_LOG + 1); i; --i)
+        x *= 2;
+    for (size_t i = rand_below(DECI_BASE_LOG + 1); i; --i)
+        x *= 5;
+    return x == DECI_BASE ? x / 10 : x;
+}
+
+static void check_prod_uwords(void)
+{
+    const size_t k = gen_len(0, 2 * MAXW);
+    deci_UWORD factors[2 * MAXW];
+    const int mode = rand_below(8);
+    for (size_t i = 0; i < k; ++i) {
+        switch (mode) {
+        case 0:
+            factors[i] = gen_word();
+            break;
+        case 1:
+        case 2:
+            factors[i] = gen_base_divisor();
+            break;
+        default:
+            factors[i] = gen_nonzero_word();
+            break;
+        }
+    }
+    note("factors", factors, k);
+
+    Ref want, got;
+    ref_from_u64(&want, 1);
+    for (size_t i = 0; i < k; ++i)
+        ref_mul_u64(&want, &want, factors[i]);
+
+    deci_UWORD *out = buf_place(&buf_c, k + 2);
+    deci_UWORD *scratch = buf_place(&buf_d, k + 2);
+    const size_t nr = deci_prod_uwords(factors, k, out, scratch);
+    CHECK(nr <= k + 2);
+    get(&got, out, nr);
+    CHECK(got.n == 0 || out[nr - 1] != 0);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+// Small enough for the buffers of 'deci_factorial(n)' and 'deci_binomial(n, k)' to fit into a 'Buf'.
+enum { MAX_FACTORIAL = BUF_CAP - 8 };
+
+static void check_factorial(void)
+{
+    const size_t n = gen_len(0, MAX_FACTORIAL);
+    note_word("n", n);
+
+    Ref want, got;
+    ref_from_u64(&want, 1);
+    for (size_t i = 2; i <= n; ++i)
+        ref_mul_u64(&want, &want, i);
+
+    const size_t cap = deci_factorial_nwords_max(n);
+    deci_UWORD *out = buf_place(&buf_c, cap);
+    deci_UWORD *scratch = buf_place(&buf_d, cap);
+    const size_t nr = deci_factorial(n, out, scratch);
+    get(&got, out, nr);
+    CHECK(got.n == 0 || out[nr - 1] != 0);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_binomial(void)
+{
+    // Either small 'n', or 'n' of up to two words with small 'k'.
+    size_t n, k;
+    if (rand_below(2)) {
+        n = gen_len(0, MAX_FACTORIAL);
+        k = gen_len(0, n + 1);
+    } else {
+        const deci_DOUBLE_UWORD base_sq = ((deci_DOUBLE_UWORD) DECI_BASE) * DECI_BASE;
+        n = rand_below(2) ? base_sq - 1 - rand_below(8) : rand_u64() % base_sq;
+        k = rand_below(2) ? rand_below(5) : n - rand_below(5);
+    }
+    note_word("n", n);
+    note_word("k", k);
+
+    Ref want, got;
+    if (k > n) {
+        want.n = 0;
+    } else {
+        const size_t kk = k < n - k ? k : n - k;
+        Ref num, den, rem;
+        ref_from_u64(&num, 1);
+        ref_from_u64(&den, 1);
+        for (size_t i = 1; i <= kk; ++i) {
+            ref_mul_u64(&num, &num, n - kk + i);
+            ref_mul_u64(&den, &den, i);
+        }
+        ref_divmod(&want, &rem, &num, &den);
+        CHECK(rem.n == 0);
+    }
+
+    const size_t cap = deci_binomial_nwords_max(n, k);
+    deci_UWORD *out = buf_place(&buf_c, cap);
+    deci_UWORD *scratch = buf_place(&buf_d, 2 * cap);
+    const size_t nr = deci_binomial(n, k, out, scratch);
+    get(&got, out, nr);
+    CHECK(got.n == 0 || out[nr - 1] != 0);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_divmod_uword(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    const deci_UWORD y = gen_nonzero_word();
+    note("a", a, n);
+    note_word("y", y);
+
+    Ref ra, ry, q, r, got;
+    ref_from_span(&ra, a, n);
+    ref_from_u64(&ry, y);
+    ref_divmod(&q, &r, &ra, &ry);
+
+    const deci_UWORD rem = deci_mod_uword(a, a + n, y);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &ra));
+    ref_from_u64(&got, rem);
+    CHECK(ref_eq(&got, &r));
+
+    const deci_UWORD rem2 = deci_divmod_uword(a, a + n, y);
+    CHECK(rem2 == rem);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &q));
+    buf_check(&buf_a);
+}
+
+// More than two blocks of 'deci_mod_uword_multi()'.
+enum { MAX_MULTI = 70 };
+
+static void check_mod_uword_multi(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    const size_t k = gen_len(0, MAX_MULTI);
+    deci_UWORD divisors[MAX_MULTI];
+    for (size_t i = 0; i < k; ++i)
+        divisors[i] = gen_nonzero_word();
+    note("a", a, n);
+    note("divisors", divisors, k);
+
+    deci_UWORD *out = buf_place(&buf_c, k);
+    deci_mod_uword_multi(a, a + n, divisors, k, out);
+    for (size_t i = 0; i < k; ++i)
+        CHECK(out[i] == deci_mod_uword(a, a + n, divisors[i]));
+    buf_check(&buf_a);
+    buf_check(&buf_c);
+}
+
+static deci_UWORD gcd_uword(deci_UWORD a, deci_UWORD b)
+{
+    while (b) {
+        const deci_UWORD t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void check_crt(void)
+{
+    const size_t k_max = gen_len(0, MAXW);
+    deci_UWORD moduli[MAXW];
+    deci_UWORD residues[MAXW];
+    size_t k = 0;
+    for (size_t attempt = 0; k < k_max && attempt < 4 * MAXW; ++attempt) {
+        const deci_UWORD p = gen_nonzero_word();
+        bool coprime = true;
+        for (size_t i = 0; i < k; ++i)
+            coprime = coprime && gcd_uword(moduli[i], p) == 1;
+        if (coprime)
+            moduli[k++] = p;
+    }
+    for (size_t i = 0; i < k; ++i) {
+        switch (rand_below(3)) {
+        case 0:
+            residues[i] = 0;
+            break;
+        case 1:
+            residues[i] = moduli[i] - 1;
+            break;
+        default:
+            residues[i] = rand_u64() % moduli[i];
+            break;
+        }
+    }
+    note("moduli", moduli, k);
+    note("residues", residues, k);
+
+    deci_UWORD *out = buf_place(&buf_c, k);
+    const size_t n = deci_crt(residues, moduli, k, out);
+    CHECK(n <= k);
+    CHECK(n == 0 || out[n - 1] != 0);
+
+    Ref got, product, x;
+    get(&got, out, n);
+    ref_from_u64(&product, 1);
+    for (size_t i = 0; i < k; ++i) {
+        ref_mul_u64(&x, &product, moduli[i]);
+        product = x;
+        CHECK(deci_mod_uword(out, out + n, moduli[i]) == residues[i]);
+    }
+    CHECK(ref_cmp(&got, &product) < 0);
+    buf_check(&buf_c);
+}
+
+// Generates a dividend for the divisor (b ... b + nb), placing it into 'buf_a' and returning its
+// length. Sometimes the dividend is made to have a remainder just below the divisor, or to share the
+// top words with it, as these are the inputs that need quotient corrections.
+static size_t gen_dividend(deci_UWORD **pa, const deci_UWORD *b, size_t nb, size_t min_na)
+{
+    size_t na;
+    deci_UWORD *a;
+    switch (rand_below(4)) {
+    case 0:
+        {
+            Ref rb, q, r, one, x;
+            ref_from_span(&rb, b, nb);
+            const size_t nq = gen_len(0, MAXW - nb);
+            deci_UWORD wq[MAXW];
+            gen_span(wq, nq);
+            ref_from_span(&q, wq, nq);
+            ref_from_u64(&one, 1 + rand_below(3));
+            r = rb;
+            if (ref_cmp(&r, &one) >= 0)
+                ref_sub(&r, &r, &one);
+            ref_mul(&x, &q, &rb);
+            ref_add(&x, &x, &r);
+            na = ref_nwords(&x);
+            if (na < min_na)
+                na = min_na;
+            a = buf_place(&buf_a, na);
+            ref_to_span(&x, a, na);
+        }
+        break;
+    case 1:
+        na = gen_len(nb > min_na ? nb : min_na, MAXW);
+        a = buf_place(&buf_a, na);
+        gen_span(a, na);
+        if (nb)
+            memcpy(a + na - nb, b, nb * sizeof(deci_UWORD));
+        if (nb && rand_below(2))
+            a[na - nb] = rand_u64() % DECI_BASE;
+        break;
+    default:
+        na = gen_len(min_na, MAXW);
+        a = buf_place(&buf_a, na);
+        gen_span(a, na);
+        break;
+    }
+    *pa = a;
+    return na;
+}
+
+static void check_divmod_unsafe(void)
+{
+    const size_t nb = gen_len(2, MAXW);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_normalized_span(b, nb);
+    deci_UWORD *a;
+    const size_t na = gen_dividend(&a, b, nb, nb);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, q, r, got, x;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_divmod(&q, &r, &ra, &rb);
+
+    const deci_UWORD qhi = deci_divmod_unsafe(a, a + na, b, b + nb);
+    CHECK(qhi < DECI_BASE);
+    get(&got, a, nb);
+    CHECK(ref_eq(&got, &r));
+    get(&got, a + nb, na - nb);
+    ref_from_u64(&x, qhi);
+    ref_shl10(&x, &x, (na - nb) * DECI_BASE_LOG);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &q));
+    get(&x, b, nb);
+    CHECK(ref_eq(&x, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+// Checks 'deci_divmod_dword()' and 'deci_divmod_tword()'. The divisor does not have to be
+// normalized, and is sometimes made a power of two, which is where the reciprocal is exact.
+static void check_divmod_short(void)
+{
+    const size_t nb = 2 + rand_below(2);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    deci_QUAD_UWORD bv = 0;
+    if (rand_below(4)) {
+        gen_span(b, nb);
+        if (deci_is_zero_n(b, nb))
+            b[rand_below(nb)] = gen_nonzero_word();
+        for (size_t i = nb; i;)
+            bv = bv * DECI_BASE + b[--i];
+    } else {
+        deci_QUAD_UWORD limit = 1;
+        for (size_t i = 0; i < nb; ++i)
+            limit *= DECI_BASE;
+        unsigned k = 0;
+        while ((((deci_QUAD_UWORD) 2) << k) < limit)
+            ++k;
+        bv = ((deci_QUAD_UWORD) 1) << rand_below(k + 1);
+        deci_QUAD_UWORD x = bv;
+        for (size_t i = 0; i < nb; ++i) {
+            b[i] = x % DECI_BASE;
+            x /= DECI_BASE;
+        }
+    }
+    deci_UWORD *a;
+    const size_t na = gen_dividend(&a, b, nb, 0);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, q, r, got;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_divmod(&q, &r, &ra, &rb);
+
+    deci_QUAD_UWORD rv = nb == 2
+        ? deci_divmod_dword(a, a + na, (deci_DOUBLE_UWORD) bv)
+        : deci_divmod_tword(a, a + na, bv);
+    CHECK(rv < bv);
+    deci_UWORD rw[3];
+    for (size_t i = 0; i < nb; ++i) {
+        rw[i] = rv % DECI_BASE;
+        rv /= DECI_BASE;
+    }
+    get(&got, rw, nb);
+    CHECK(ref_eq(&got, &r));
+    get(&got, a, na);
+    CHECK(ref_eq(&got, &q));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_div_mod(bool div)
+{
+    const size_t nb = gen_len(1, MAXW);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(b, nb);
+    if (deci_is_zero_n(b, nb))
+        b[rand_below(nb)] = gen_nonzero_word();
+    deci_UWORD *a;
+    const size_t na = gen_dividend(&a, b, nb, 0);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, q, r, got;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_divmod(&q, &r, &ra, &rb);
+
+    const size_t n = div
+        ? deci_div(a, a + na, b, b + nb)
+        : deci_mod(a, a + na, b, b + nb);
+    CHECK(n <= na);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, div ? &q : &r));
+    get(&got, b, nb);
+    CHECK(ref_eq(&got, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_div(void)
+{
+    check_div_mod(true);
+}
+
+static void check_mod(void)
+{
+    check_div_mod(false);
+}
+
+// Checks 'deci_divrem()' if 'mode' is 0, 'deci_div_appr()' if it is 1, and 'deci_quotient()' if it
+// is 2.
+static void check_out_of_place_div(int mode)
+{
+    const size_t nb = gen_len(1, MAXW);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_span(b, nb);
+    if (deci_is_zero_n(b, nb))
+        b[rand_below(nb)] = gen_nonzero_word();
+    deci_UWORD *a;
+    const size_t na = gen_dividend(&a, b, nb, 0);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, q, r, got;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_divmod(&q, &r, &ra, &rb);
+
+    deci_UWORD *q_out = buf_place(&buf_c, na);
+    size_t nq;
+    if (mode == 0) {
+        deci_UWORD *r_out = buf_place(&buf_d, na);
+        size_t nr;
+        nq = deci_divrem(a, a + na, b, b + nb, q_out, r_out, &nr);
+        CHECK(nr <= na);
+        get(&got, r_out, nr);
+        CHECK(ref_eq(&got, &r));
+    } else {
+        deci_UWORD *scratch = buf_place(&buf_d, mode == 1 ? na : 2 * na);
+        nq = mode == 1
+            ? deci_div_appr(a, a + na, b, b + nb, q_out, scratch)
+            : deci_quotient(a, a + na, b, b + nb, q_out, scratch);
+    }
+    CHECK(nq <= na);
+    get(&got, q_out, nq);
+    if (mode == 1 && !ref_eq(&got, &q)) {
+        Ref one;
+        ref_from_u64(&one, 1);
+        ref_add(&q, &q, &one);
+    }
+    CHECK(ref_eq(&got, &q));
+
+    get(&got, a, na);
+    CHECK(ref_eq(&got, &ra));
+    get(&got, b, nb);
+    CHECK(ref_eq(&got, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_divrem(void)
+{
+    check_out_of_place_div(0);
+}
+
+static void check_div_appr(void)
+{
+    check_out_of_place_div(1);
+}
+
+static void check_quotient(void)
+{
+    check_out_of_place_div(2);
+}
+
+// Multiplies 'r' by a random power of 2, 5 or 10, or leaves it as is; these are the factors an
+// exact division has to strip from the divisor.
+static void gen_base_factors(Ref *r)
+{
+    switch (rand_below(4)) {
+    case 0:
+        ref_mul_u64(r, r, 1ull << rand_below(64));
+        break;
+    case 1:
+        {
+            uint64_t x = 1;
+            for (size_t k = rand_below(28); k; --k)
+                x *= 5;
+            ref_mul_u64(r, r, x);
+        }
+        break;
+    case 2:
+        ref_shl10(r, r, rand_below(3 * DECI_BASE_LOG));
+        break;
+    }
+}
+
+static void check_divexact_uword(void)
+{
+    Ref ry;
+    do {
+        ref_from_u64(&ry, rand_below(2) ? gen_nonzero_word() : 1);
+        gen_base_factors(&ry);
+    } while (ry.n > DECI_BASE_LOG);
+    deci_UWORD y;
+    ref_to_span(&ry, &y, 1);
+    const size_t nq = gen_len(0, MAXW - 1);
+    deci_UWORD wq[MAXW];
+    gen_span(wq, nq);
+
+    Ref q, ra, got;
+    ref_from_span(&q, wq, nq);
+    ref_mul_u64(&ra, &q, y);
+    const size_t n = ref_nwords(&ra) + rand_below(2);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    ref_to_span(&ra, a, n);
+    note("a", a, n);
+    note_word("y", y);
+
+    deci_divexact_uword(a, a + n, y);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &q));
+    buf_check(&buf_a);
+}
+
+static void check_divexact(void)
+{
+    Ref rb, q, ra, got;
+    do {
+        deci_UWORD w[MAXW];
+        const size_t n = gen_len(1, MAXW / 2);
+        gen_normalized_span(w, n);
+        ref_from_span(&rb, w, n);
+        gen_base_factors(&rb);
+    } while (ref_nwords(&rb) > MAXW - 1);
+
+    const size_t nb = ref_nwords(&rb) + rand_below(2);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    ref_to_span(&rb, b, nb);
+
+    const size_t nq = gen_len(0, MAXW - nb);
+    deci_UWORD wq[MAXW];
+    gen_span(wq, nq);
+    ref_from_span(&q, wq, nq);
+    ref_mul(&ra, &q, &rb);
+
+    const size_t na = ref_nwords(&ra) + rand_below(2);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    ref_to_span(&ra, a, na);
+    note("a", a, na);
+    note("b", b, nb);
+
+    deci_UWORD *scratch = buf_place(&buf_c, nb);
+    const size_t n = deci_divexact(a, a + na, b, b + nb, scratch);
+    CHECK(n <= na);
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &q));
+    get(&got, b, nb);
+    CHECK(ref_eq(&got, &rb));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_tobits_round(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+
+    Ref ra, got, x;
+    ref_from_span(&ra, a, n);
+
+    const deci_UWORD r = deci_tobits_round(a, a + n);
+    get(&got, a, n);
+    ref_mul_u64(&got, &got, (uint64_t) 1 << DECI_WORD_BITS);
+    ref_from_u64(&x, r);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &ra));
+    buf_check(&buf_a);
+}
+
+static void check_tolong(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+
+    const size_t nd = n / 2 + n % 2;
+    deci_DOUBLE_UWORD d[MAXW / 2 + 2];
+    d[nd] = 12345;
+
+    deci_tolong(a, a + n, d);
+    for (size_t i = 0; i < nd; ++i) {
+        const deci_DOUBLE_UWORD hi = 2 * i + 1 < n ? a[2 * i + 1] : 0;
+        CHECK(d[i] == a[2 * i] + hi * DECI_BASE);
+    }
+    CHECK(d[nd] == 12345);
+    buf_check(&buf_a);
+}
+
+static void check_long_tobits_round(void)
+{
+    const size_t n = gen_len(0, MAXW / 2);
+    deci_UWORD lo[MAXW / 2], hi[MAXW / 2];
+    gen_span(lo, n);
+    gen_span(hi, n);
+    deci_DOUBLE_UWORD d[MAXW / 2];
+    for (size_t i = 0; i < n; ++i)
+        d[i] = lo[i] + hi[i] * (deci_DOUBLE_UWORD) DECI_BASE;
+    note("lo", lo, n);
+    note("hi", hi, n);
+
+    Ref rd, got, x;
+    ref_from_long_span(&rd, d, n);
+
+    const deci_DOUBLE_UWORD r = deci_long_tobits_round(d, d + n);
+    for (size_t i = 0; i < n; ++i)
+        CHECK(d[i] < DECI_BASE * (deci_DOUBLE_UWORD) DECI_BASE);
+    ref_from_long_span(&got, d, n);
+    Ref two_pow;
+    ref_from_u64(&two_pow, (uint64_t) 1 << (DECI_DOUBLE_WORD_BITS / 2));
+    ref_mul(&got, &got, &two_pow);
+    ref_mul(&got, &got, &two_pow);
+    ref_from_u64(&x, r);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &rd));
+}
+
+static void check_frombits_round(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+
+    Ref ra, want, got, x;
+    ref_from_span(&ra, a, n);
+    ref_mul_u64(&want, &ra, (uint64_t) 1 << DECI_WORD_BITS);
+
+    const deci_UWORD hi = deci_frombits_round(a, a + n);
+    get(&got, a, n);
+    ref_from_u64(&x, hi);
+    ref_shl10(&x, &x, n * DECI_BASE_LOG);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+}
+
+static void check_mul_pow2(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    // Leave room for the product: (2^3 < 10).
+    const size_t nzero = rand_below(n + 1);
+    deci_zero_out_n(a + n - nzero, nzero);
+    const size_t k = rand_below((nzero + 1) * DECI_BASE_LOG * 3 + 1);
+    note("a", a, n);
+    note_word("k", k);
+
+    Ref ra, want, got, x;
+    ref_from_span(&ra, a, n);
+    want = ra;
+    ref_mul_pow2(&want, k);
+
+    const deci_UWORD hi = deci_mul_pow2(a, a + n, k);
+    CHECK(hi < DECI_BASE);
+    get(&got, a, n);
+    ref_from_u64(&x, hi);
+    ref_shl10(&x, &x, n * DECI_BASE_LOG);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+}
+
+static void check_divmod_pow2(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    if (rand_below(16) == 0) {
+        // Shifts by nearly all of 'size_t', within a few passes of wrapping around, must still
+        // end, with a quotient of zero.
+        const size_t k = SIZE_MAX - rand_below(6 * DECI_WORD_BITS);
+        note("a", a, n);
+        note_word("k", k);
+        CHECK(deci_divmod_pow2(a, a + n, k, NULL) == 0);
+        CHECK(deci_is_zero_n(a, n));
+        buf_check(&buf_a);
+        return;
+    }
+    // Up to well past the size of 'a'.
+    const size_t k = rand_below(n * DECI_BASE_LOG * 4 + 2);
+    const size_t nrem = (k / DECI_WORD_BITS) + !!(k % DECI_WORD_BITS);
+    deci_UWORD *rem = rand_below(4) ? buf_place(&buf_b, nrem) : NULL;
+    note("a", a, n);
+    note_word("k", k);
+
+    Ref ra, p, want_q, want_r, got, x;
+    ref_from_span(&ra, a, n);
+    ref_from_u64(&p, 1);
+    ref_mul_pow2(&p, k);
+    ref_divmod(&want_q, &want_r, &ra, &p);
+
+    const size_t nq = deci_divmod_pow2(a, a + n, k, rem);
+    CHECK(nq <= n);
+    CHECK(nq == 0 || a[nq - 1] != 0);
+    for (size_t i = nq; i < n; ++i)
+        CHECK(a[i] == 0);
+    get(&got, a, nq);
+    CHECK(ref_eq(&got, &want_q));
+    buf_check(&buf_a);
+
+    if (rem) {
+        got.n = 0;
+        for (size_t i = nrem; i--;) {
+            ref_mul_pow2(&got, DECI_WORD_BITS);
+            ref_from_u64(&x, rem[i]);
+            ref_add(&got, &got, &x);
+        }
+        CHECK(ref_eq(&got, &want_r));
+        buf_check(&buf_b);
+    }
+}
+
+static void check_shl10(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    const size_t k = rand_below(n * DECI_BASE_LOG + 1);
+    const size_t nzero = k / DECI_BASE_LOG;
+    deci_zero_out_n(a + n - nzero, nzero);
+    note("a", a, n);
+    note_word("k", k);
+
+    Ref ra, want, got, x;
+    ref_from_span(&ra, a, n);
+    ref_shl10(&want, &ra, k);
+
+    const deci_UWORD hi = deci_shl10(a, a + n, k);
+    CHECK(hi < DECI_BASE);
+    get(&got, a, n);
+    ref_from_u64(&x, hi);
+    ref_shl10(&x, &x, n * DECI_BASE_LOG);
+    ref_add(&got, &got, &x);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+}
+
+static void check_shr10(bool round)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    const size_t k = rand_below((n + 2) * DECI_BASE_LOG + 1);
+    const size_t nrem = k / DECI_BASE_LOG + !!(k % DECI_BASE_LOG);
+    deci_UWORD *rem = rand_below(4) ? buf_place(&buf_c, nrem) : NULL;
+    if (n && round && rand_below(3) == 0) {
+        // Make a tie: the shifted-out digits are exactly 5 followed by zeros.
+        Ref ra, half;
+        ref_from_span(&ra, a, n);
+        if (k) {
+            ref_pow10(&half, k - 1);
+            ref_mul_u64(&half, &half, 5);
+            const size_t nk = k < ra.n ? k : ra.n;
+            memset(ra.d, 0, nk);
+            ref_normalize(&ra);
+            ref_add(&ra, &ra, &half);
+            if (ref_nwords(&ra) <= n)
+                ref_to_span(&ra, a, n);
+        }
+    }
+    note("a", a, n);
+    note_word("k", k);
+
+    Ref ra, p, q, r, got;
+    ref_from_span(&ra, a, n);
+    ref_pow10(&p, k);
+    ref_divmod(&q, &r, &ra, &p);
+    if (round) {
+        Ref r2;
+        ref_add(&r2, &r, &r);
+        const int c = ref_cmp(&r2, &p);
+        if (c > 0 || (c == 0 && ref_is_odd(&q))) {
+            Ref one;
+            ref_from_u64(&one, 1);
+            ref_add(&q, &q, &one);
+        }
+    }
+
+    const size_t nq = round
+        ? deci_shr10_round(a, a + n, k, rem)
+        : deci_shr10(a, a + n, k, rem);
+    CHECK(nq <= n);
+    get(&got, a, nq);
+    CHECK(ref_eq(&got, &q));
+    CHECK(deci_is_zero_n(a + nq, n - nq));
+    if (rem) {
+        get(&got, rem, nrem);
+        CHECK(ref_eq(&got, &r));
+        buf_check(&buf_c);
+    }
+    buf_check(&buf_a);
+}
+
+static void check_shr10_trunc(void)
+{
+    check_shr10(false);
+}
+
+static void check_shr10_round(void)
+{
+    check_shr10(true);
+}
+
+// Raises 'a' to the power of 'k', by repeated squaring.
+static void ref_pow(Ref *r, const Ref *a, size_t k)
+{
+    Ref x = *a;
+    ref_from_u64(r, 1);
+    for (; k; k >>= 1) {
+        if (k & 1)
+            ref_mul(r, r, &x);
+        if (k > 1)
+            ref_mul(&x, &x, &x);
+    }
+}
+
+// Results of up to this many words fit into a 'Buf'.
+enum { MAX_POW_NWORDS = BUF_CAP - 8 };
+
+static void check_pow(void)
+{
+    size_t n = gen_len(0, MAXW / 2);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    switch (rand_below(4)) {
+    case 0:
+        // A power of ten, possibly with garbage above it to be normalized away.
+        deci_zero_out_n(a, n);
+        if (n) {
+            const size_t t = rand_below(n * DECI_BASE_LOG);
+            a[t / DECI_BASE_LOG] = 1;
+            for (size_t i = t % DECI_BASE_LOG; i; --i)
+                a[t / DECI_BASE_LOG] *= 10;
+        }
+        break;
+    case 1:
+        deci_zero_out_n(a, n);
+        if (n)
+            a[0] = rand_below(2) ? 2 : 1 + rand_below(16);
+        break;
+    default:
+        gen_span(a, n);
+        break;
+    }
+    const size_t nn = deci_normalize_n(a, n);
+    const size_t k = rand_below(4) == 0 ? rand_below(3) : gen_len(0, nn ? MAX_POW_NWORDS / nn : 1000);
+    note("a", a, n);
+    note_word("k", k);
+
+    Ref ra, want, got;
+    ref_from_span(&ra, a, n);
+    ref_pow(&want, &ra, k);
+
+    const size_t cap = deci_pow_nwords_max(nn, k);
+    deci_UWORD *out = buf_place(&buf_c, cap);
+    deci_UWORD *scratch = buf_place(&buf_d, cap);
+    const size_t nr = deci_pow(a, a + n, k, out, scratch);
+    CHECK(nr <= cap);
+    get(&got, out, nr);
+    CHECK(got.n == 0 || out[nr - 1] != 0);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_pow2(void)
+{
+    // (log10(2) > 0.3)
+    const size_t k = gen_len(0, (MAX_POW_NWORDS - 2) * DECI_BASE_LOG * 10 / 3);
+    note_word("k", k);
+
+    Ref want, got;
+    ref_from_u64(&want, 1);
+    ref_mul_pow2(&want, k);
+
+    const size_t cap = deci_pow2_nwords_max(k);
+    CHECK(cap <= ref_nwords(&want) + 2);
+    deci_UWORD *out = buf_place(&buf_c, cap);
+    deci_UWORD *scratch = buf_place(&buf_d, cap);
+    const size_t nr = deci_pow2(k, out, scratch);
+    get(&got, out, nr);
+    CHECK(out[nr - 1] != 0);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_sqrtrem(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    if (n && rand_below(4) == 0) {
+        // Make a perfect square, or one less than a perfect square.
+        const size_t nh = n / 2;
+        deci_UWORD h[MAXW];
+        gen_span(h, nh);
+        Ref rh, x;
+        ref_from_span(&rh, h, nh);
+        ref_mul(&x, &rh, &rh);
+        if (x.n && rand_below(2)) {
+            Ref one;
+            ref_from_u64(&one, 1);
+            ref_sub(&x, &x, &one);
+        }
+        ref_to_span(&x, a, n);
+    }
+    note("a", a, n);
+
+    const size_t ncap = n / 2 + n % 2 + 1;
+    deci_UWORD *out = buf_place(&buf_c, ncap);
+
+    Ref ra, s, r, x;
+    ref_from_span(&ra, a, n);
+
+    const size_t ns = deci_sqrtrem(a, a + n, out);
+    CHECK(ns < ncap);
+    get(&s, out, ns);
+    get(&r, a, n);
+    // s^2 + r == a and r <= 2s
+    ref_mul(&x, &s, &s);
+    ref_add(&x, &x, &r);
+    CHECK(ref_eq(&x, &ra));
+    ref_add(&x, &s, &s);
+    CHECK(ref_cmp(&r, &x) <= 0);
+    buf_check(&buf_a);
+    buf_check(&buf_c);
+}
+
+// Generates a pair of operands for gcd, (na >= nb), sometimes with a large common factor.
+static void gen_gcd_operands(deci_UWORD **pa, size_t *pna, deci_UWORD **pb, size_t *pnb)
+{
+    size_t na, nb;
+    deci_UWORD *a, *b;
+    if (rand_below(3) == 0) {
+        const size_t ng = gen_len(1, MAXW / 2);
+        const size_t nx = gen_len(0, MAXW - ng);
+        const size_t ny = gen_len(0, MAXW - ng);
+        deci_UWORD wg[MAXW], wx[MAXW], wy[MAXW];
+        gen_normalized_span(wg, ng);
+        gen_span(wx, nx);
+        gen_span(wy, ny);
+        Ref g, x, y;
+        ref_from_span(&g, wg, ng);
+        ref_from_span(&x, wx, nx);
+        ref_from_span(&y, wy, ny);
+        ref_mul(&x, &x, &g);
+        ref_mul(&y, &y, &g);
+        if (ref_nwords(&x) < ref_nwords(&y)) {
+            const Ref t = x;
+            x = y;
+            y = t;
+        }
+        na = ref_nwords(&x);
+        nb = ref_nwords(&y);
+        a = buf_place(&buf_a, na);
+        b = buf_place(&buf_b, nb);
+        ref_to_span(&x, a, na);
+        ref_to_span(&y, b, nb);
+    } else {
+        na = gen_len(0, MAXW);
+        nb = gen_len(0, na);
+        a = buf_place(&buf_a, na);
+        b = buf_place(&buf_b, nb);
+        gen_span(a, na);
+        gen_span(b, nb);
+    }
+    *pa = a;
+    *pna = na;
+    *pb = b;
+    *pnb = nb;
+}
+
+static void check_gcd(void)
+{
+    deci_UWORD *a, *b;
+    size_t na, nb;
+    gen_gcd_operands(&a, &na, &b, &nb);
+    deci_UWORD *scratch = buf_place(&buf_c, na);
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, want, got;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_gcd(&want, &ra, &rb);
+
+    const size_t ng = deci_gcd(a, a + na, b, b + nb, scratch);
+    CHECK(ng <= na);
+    get(&got, a, ng);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_gcdext(void)
+{
+    deci_UWORD *a, *b;
+    size_t na, nb;
+    gen_gcd_operands(&a, &na, &b, &nb);
+    deci_UWORD *ws = buf_place(&buf_c, nb + 1);
+    deci_UWORD *scratch = buf_place(&buf_d, na + 2 * (nb + 1));
+    note("a", a, na);
+    note("b", b, nb);
+
+    Ref ra, rb, want, got, s, x, y;
+    ref_from_span(&ra, a, na);
+    ref_from_span(&rb, b, nb);
+    ref_gcd(&want, &ra, &rb);
+
+    size_t ns;
+    bool s_negative;
+    const size_t ng = deci_gcdext(a, a + na, b, b + nb, ws, &ns, &s_negative, scratch);
+    CHECK(ng <= na);
+    CHECK(ns <= nb + 1);
+    get(&got, a, ng);
+    CHECK(ref_eq(&got, &want));
+    get(&s, ws, ns);
+
+    if (!rb.n) {
+        CHECK(!s_negative);
+        CHECK(s.n == 1 && s.d[0] == 1);
+    } else {
+        CHECK(ref_cmp(&s, &rb) <= 0);
+        // (s * a == g) modulo b
+        ref_mul(&x, &s, &ra);
+        if (s_negative) {
+            ref_add(&x, &x, &got);
+            ref_divmod(NULL, &y, &x, &rb);
+            CHECK(y.n == 0);
+        } else {
+            Ref z;
+            ref_divmod(NULL, &y, &x, &rb);
+            ref_divmod(NULL, &z, &got, &rb);
+            CHECK(ref_eq(&y, &z));
+        }
+    }
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+// Sets the bits of word 'i' of the packed span, which starts at byte 'nhead' of 'p', to 'w'.
+static void packed_set_word(unsigned char *p, size_t nhead, size_t i, deci_UWORD w)
+{
+    for (size_t j = 0; j < DECI_PACKED_BITS; ++j) {
+        const size_t bit = i * DECI_PACKED_BITS + j;
+        const unsigned char mask = 1u << (bit % 8);
+        if ((w >> j) & 1)
+            p[nhead + bit / 8] |= mask;
+        else
+            p[nhead + bit / 8] &= ~mask;
+    }
+}
+
+static void check_pack(void)
+{
+    enum { GUARD = 16 };
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+    const size_t nn = deci_normalize_n(a, n);
+
+    const size_t nmax = deci_packed_size_max(n);
+    unsigned char p[(sizeof(size_t) * 8 + 6) / 7 + MAXW * DECI_PACKED_BITS / 8 + GUARD];
+    CHECK(nmax + GUARD <= sizeof(p));
+    memset(p, 0xA5, sizeof(p));
+
+    const size_t np = deci_pack(a, a + n, p);
+    size_t nhead = 1;
+    for (size_t x = nn; x >= 0x80; x >>= 7)
+        ++nhead;
+    CHECK(np == nhead + (nn * DECI_PACKED_BITS + 7) / 8);
+    CHECK(np <= nmax);
+    for (size_t i = nmax; i < sizeof(p); ++i)
+        CHECK(p[i] == 0xA5);
+
+    // Truncated input is rejected; trailing bytes are ignored.
+    CHECK(deci_unpacked_nwords(p, np - 1) == (size_t) -1);
+    CHECK(deci_unpack(p, np - 1, buf_place(&buf_b, nn)) == 0);
+    CHECK(deci_unpacked_nwords(p, np) == nn);
+    const size_t ntail = rand_below(GUARD);
+    CHECK(deci_unpacked_nwords(p, np + ntail) == nn);
+
+    deci_UWORD *b = buf_place(&buf_b, nn);
+    CHECK(deci_unpack(p, np + ntail, b) == np);
+    CHECK(deci_compare_n(b, a, nn, -1, 0, 1) == 0);
+
+    {
+        // A length padded with a zero byte is rejected, though it has the same value.
+        unsigned char q[sizeof(p) + 1];
+        memcpy(q, p, nhead);
+        q[nhead - 1] |= 0x80;
+        q[nhead] = 0;
+        memcpy(q + nhead + 1, p + nhead, np - nhead);
+        CHECK(deci_unpacked_nwords(q, np + 1) == (size_t) -1);
+        CHECK(deci_unpack(q, np + 1, b) == 0);
+    }
+
+    if (nn) {
+        // A word that is not less than DECI_BASE is rejected.
+        const size_t i = rand_below(nn);
+        const deci_UWORD w = DECI_BASE + rand_below(((deci_UWORD) 1 << DECI_PACKED_BITS) - DECI_BASE);
+        packed_set_word(p, nhead, i, w);
+        CHECK(deci_unpack(p, np, b) == 0);
+        packed_set_word(p, nhead, i, a[i]);
+
+        // So is a non-zero unused bit in the last byte.
+        if ((nn * DECI_PACKED_BITS) % 8) {
+            p[np - 1] ^= 0x80;
+            CHECK(deci_unpack(p, np, b) == 0);
+            p[np - 1] ^= 0x80;
+            CHECK(deci_unpack(p, np, b) == np);
+        }
+
+        // So is a non-normalized span.
+        packed_set_word(p, nhead, nn - 1, 0);
+        CHECK(deci_unpack(p, np, b) == 0);
+    }
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+// Returns the double nearest to 'r', as given by 'strtod()', which is correctly rounded in the C
+// libraries we test with.
+static double ref_to_double(const Ref *r)
+{
+    char s[REF_CAP + 1];
+    size_t n = 0;
+    for (size_t i = r->n; i--;)
+        s[n++] = '0' + r->d[i];
+    if (!n)
+        s[n++] = '0';
+    s[n] = '\0';
+    return strtod(s, NULL);
+}
+
+static void check_from_double(void)
+{
+    // The longest result 'get()' takes.
+    enum { DIGITS_MAX = 4 * MAXW * DECI_BASE_LOG };
+    const int e_max = DIGITS_MAX * 3 - 53 < 971 ? DIGITS_MAX * 3 - 53 : 971;
+    const int e_min = -((DIGITS_MAX - 17) * 10 / 7);
+
+    uint64_t m;
+    int e;
+    double x;
+    if (rand_below(4)) {
+        // A normal double, with some of the low bits of the mantissa cleared.
+        m = ((rand_u64() >> 11) | ((uint64_t) 1 << 52)) & ~(((uint64_t) 1 << rand_below(53)) - 1);
+        e = e_min + (int) rand_below(e_max - e_min + 1);
+        const uint64_t bits = (rand_u64() & ((uint64_t) 1 << 63)) | ((uint64_t) (e + 1075) << 52) |
+                              (m & (((uint64_t) 1 << 52) - 1));
+        memcpy(&x, &bits, sizeof(x));
+        note_word("bits", bits);
+    } else {
+        m = rand_below(1000);
+        e = 0;
+        x = rand_below(2) ? -(double) m : (double) m;
+        note_word("x", m);
+    }
+
+    Ref want;
+    size_t want_scale = 0;
+    for (; m && e < 0 && !(m & 1); ++e)
+        m >>= 1;
+    ref_from_u64(&want, m);
+    if (e >= 0) {
+        ref_mul_pow2(&want, e);
+    } else {
+        want_scale = -e;
+        for (int i = 0; i < -e; ++i)
+            ref_mul_u64(&want, &want, 5);
+    }
+
+    // The result must not go past its own size.
+    const size_t nwant = ref_nwords(&want);
+    deci_UWORD *out = buf_place(&buf_a, nwant);
+    size_t scale;
+    const size_t n = deci_from_double(x, out, &scale);
+    CHECK(n == nwant);
+    CHECK(scale == want_scale);
+    Ref got;
+    get(&got, out, n);
+    CHECK(ref_eq(&got, &want));
+    buf_check(&buf_a);
+
+    if (!scale)
+        CHECK(deci_to_double(out, out + n) == (x < 0 ? -x : x));
+}
+
+static void check_to_double(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    // The number of bits by which a midpoint between two doubles, of 54 bits, can be shifted so
+    // that it still fits: ((54 + s) / 3.32) digits, rounded up, must not be more than n words.
+    const int s_max = ((int) n * DECI_BASE_LOG - 1) * 3 - 54;
+    if (s_max < 0 || rand_below(2)) {
+        gen_span(a, n);
+    } else {
+        // A value at, or right next to, such a midpoint.
+        Ref mid, delta;
+        ref_from_u64(&mid, (rand_u64() >> 10) | ((uint64_t) 1 << 53) | 1);
+        ref_mul_pow2(&mid, rand_below(s_max + 1));
+        ref_from_u64(&delta, rand_below(3));
+        if (rand_below(2))
+            ref_add(&mid, &mid, &delta);
+        else
+            ref_sub(&mid, &mid, &delta);
+        CHECK(ref_nwords(&mid) <= n);
+        ref_to_span(&mid, a, n);
+    }
+    note("a", a, n);
+
+    Ref ra, got;
+    ref_from_span(&ra, a, n);
+    CHECK(deci_to_double(a, a + n) == ref_to_double(&ra));
+    get(&got, a, n);
+    CHECK(ref_eq(&got, &ra));
+    buf_check(&buf_a);
+}
+
+#if DECI_WE_ARE_64_BIT
+typedef uint16_t OtherWord;
+enum { OTHER_BASE_LOG = 4 };
+#   define regroup_to_other deci_regroup_9to4
+#   define regroup_to_other_nout deci_regroup_9to4_nout
+#   define regroup_from_other deci_regroup_4to9
+#   define regroup_from_other_nout deci_regroup_4to9_nout
+#else
+typedef uint32_t OtherWord;
+enum { OTHER_BASE_LOG = 9 };
+#   define regroup_to_other deci_regroup_4to9
+#   define regroup_to_other_nout deci_regroup_4to9_nout
+#   define regroup_from_other deci_regroup_9to4
+#   define regroup_from_other_nout deci_regroup_9to4_nout
+#endif
+
+// Returns decimal digit 'i' of the span (w ... w + n) of base (10 ^ base_log).
+static unsigned span_digit(const void *w, size_t word_size, size_t n, int base_log, size_t i)
+{
+    const size_t j = i / base_log;
+    if (j >= n)
+        return 0;
+    unsigned long x = word_size == 2 ? ((const uint16_t *) w)[j] : ((const uint32_t *) w)[j];
+    for (size_t k = i % base_log; k; --k)
+        x /= 10;
+    return x % 10;
+}
+
+static void check_regroup(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    note("a", a, n);
+
+    OtherWord o[3 * MAXW];
+    const size_t nout = regroup_to_other_nout(n);
+    o[nout] = 0xABC;
+    const size_t no = regroup_to_other(a, n, o);
+    CHECK(o[nout] == 0xABC);
+    CHECK(no <= nout && (no == 0 || o[no - 1] != 0));
+    for (size_t i = no; i < nout; ++i)
+        CHECK(o[i] == 0);
+    for (size_t i = 0; i < nout * OTHER_BASE_LOG; ++i) {
+        CHECK(span_digit(o, sizeof(OtherWord), no, OTHER_BASE_LOG, i) ==
+              span_digit(a, sizeof(deci_UWORD), n, DECI_BASE_LOG, i));
+    }
+
+    deci_UWORD *b = buf_place(&buf_b, regroup_from_other_nout(no));
+    const size_t nb = regroup_from_other(o, no, b);
+    CHECK(nb == deci_normalize_n(a, n));
+    CHECK(deci_compare_n(a, b, nb, -1, 0, 1) == 0);
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static size_t gen_budget(void)
+{
+    return 1 + rand_below(rand_below(2) ? 4 : 3 * MAXW);
+}
+
+static void check_divmod_step(void)
+{
+    const size_t nb = gen_len(2, MAXW);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    gen_normalized_span(b, nb);
+    deci_UWORD *a;
+    const size_t na = gen_dividend(&a, b, nb, nb);
+    deci_UWORD *want = buf_place(&buf_c, na);
+    deci_memcpy(want, a, na);
+    const size_t budget = gen_budget();
+    note("a", a, na);
+    note("b", b, nb);
+    note_word("budget", budget);
+
+    const deci_UWORD qhi = deci_divmod_unsafe(want, want + na, b, b + nb);
+
+    deci_DivmodState st;
+    deci_divmod_begin(&st, a, a + na, b, b + nb);
+    size_t nsteps = 1;
+    while (!deci_divmod_step(&st, budget))
+        ++nsteps;
+    CHECK(deci_divmod_step(&st, budget));
+    CHECK(st.qhi == qhi);
+    CHECK(deci_compare_n(a, want, na, -1, 0, 1) == 0);
+    // Each round does at most two passes over the divisor.
+    const size_t nrounds = na - nb + 1;
+    CHECK(nsteps <= (2 * nb * nrounds + budget - 1) / budget + 1);
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_mul_step(void)
+{
+    const size_t na = gen_len(0, MAXW);
+    const size_t nb = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, na);
+    deci_UWORD *b = buf_place(&buf_b, nb);
+    deci_UWORD *out = buf_place(&buf_c, na + nb);
+    deci_UWORD *want = buf_place(&buf_d, na + nb);
+    gen_span(a, na);
+    gen_span(b, nb);
+    deci_zero_out_n(out, na + nb);
+    deci_zero_out_n(want, na + nb);
+    const size_t budget = gen_budget();
+    note("a", a, na);
+    note("b", b, nb);
+    note_word("budget", budget);
+
+    deci_mul(a, a + na, b, b + nb, want);
+
+    deci_MulState st;
+    deci_mul_begin(&st, a, a + na, b, b + nb, out);
+    size_t nsteps = 1;
+    while (!deci_mul_step(&st, budget))
+        ++nsteps;
+    CHECK(deci_mul_step(&st, budget));
+    CHECK(deci_compare_n(out, want, na + nb, -1, 0, 1) == 0);
+    CHECK(nsteps <= (na * nb + budget - 1) / budget + 1);
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+    buf_check(&buf_d);
+}
+
+static void check_tobits_step(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    gen_span(a, n);
+    deci_UWORD *want = buf_place(&buf_b, n);
+    deci_memcpy(want, a, n);
+    deci_UWORD *out = buf_place(&buf_c, n);
+    const size_t budget = gen_budget();
+    note("a", a, n);
+    note_word("budget", budget);
+
+    deci_TobitsState st;
+    deci_tobits_begin(&st, a, a + n, out);
+    while (!deci_tobits_step(&st, budget)) {
+    }
+    CHECK(deci_tobits_step(&st, budget));
+    CHECK(deci_is_zero_n(a, n));
+
+    size_t nwant = deci_normalize_n(want, n);
+    CHECK(st.nout <= n);
+    for (size_t i = 0; nwant; ++i) {
+        CHECK(i < st.nout);
+        CHECK(out[i] == deci_tobits_round(want, want + nwant));
+        nwant = deci_normalize_n(want, nwant);
+        if (!nwant)
+            CHECK(i + 1 == st.nout);
+    }
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+    buf_check(&buf_c);
+}
+
+static void check_frombits_step(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *bits = buf_place(&buf_a, n);
+    const deci_UWORD mask = rand_below(2) ? (deci_UWORD) -1 : (deci_UWORD) rand_u64();
+    for (size_t i = 0; i < n; ++i)
+        bits[i] = rand_u64() & mask;
+    const size_t nmax = deci_frombits_nwords_max(n);
+    deci_UWORD *out = buf_place(&buf_b, nmax);
+    const size_t budget = gen_budget();
+    note("bits", bits, n);
+    note_word("budget", budget);
+
+    Ref want, x;
+    ref_from_u64(&want, 0);
+    for (size_t i = n; i; --i) {
+        ref_mul_u64(&want, &want, (uint64_t) 1 << DECI_WORD_BITS);
+        ref_from_u64(&x, bits[i - 1]);
+        ref_add(&want, &want, &x);
+    }
+
+    deci_FrombitsState st;
+    deci_frombits_begin(&st, bits, bits + n, out);
+    while (!deci_frombits_step(&st, budget)) {
+    }
+    CHECK(deci_frombits_step(&st, budget));
+    CHECK(st.nout <= nmax);
+    CHECK(st.nout == 0 || out[st.nout - 1] != 0);
+    get(&x, out, st.nout);
+    CHECK(ref_eq(&x, &want));
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+static void check_helpers(void)
+{
+    const size_t n = gen_len(0, MAXW);
+    deci_UWORD *a = buf_place(&buf_a, n);
+    deci_UWORD *b = buf_place(&buf_b, n);
+    gen_span(a, n);
+    gen_span(b, n);
+    if (n && rand_below(2))
+        memcpy(b, a, (n - rand_below(n)) * sizeof(deci_UWORD));
+    note("a", a, n);
+    note("b", b, n);
+
+    Ref ra, rb;
+    ref_from_span(&ra, a, n);
+    ref_from_span(&rb, b, n);
+
+    const int c = ref_cmp(&ra, &rb);
+    CHECK(deci_compare_n(a, b, n, -1, 0, 1) == c);
+    CHECK(deci_is_zero_n(a, n) == (ra.n == 0));
+    CHECK(deci_is_zero(a, a + n) == (ra.n == 0));
+    CHECK(deci_normalize_n(a, n) == ref_nwords(&ra));
+    CHECK(deci_normalize(a, a + n) == a + ref_nwords(&ra));
+
+    size_t nlow = 0;
+    while (nlow < n && !a[nlow])
+        ++nlow;
+    CHECK(deci_skip0_n(a, n) == nlow);
+    CHECK(deci_skip0(a, a + n) == a + nlow);
+    buf_check(&buf_a);
+    buf_check(&buf_b);
+}
+
+typedef struct {
+    const char *name;
+    void (*check)(void);
+    // Relative frequency.
+    int weight;
+} Check;
+
+static const Check checks[] = {
+    {"add", check_add, 2},
+    {"sub_raw", check_sub_raw, 2},
+    {"sub", check_sub_abs, 1},
+    {"absdiff", check_absdiff, 2},
+    {"uncomplement", check_uncomplement, 1},
+    {"chunks", check_chunks, 2},
+    {"mul_uword", check_mul_uword, 1},
+    {"add_scaled", check_add_scaled, 2},
+    {"sub_scaled_raw", check_sub_scaled_raw, 2},
+    {"mul", check_mul, 2},
+    {"mul_inplace", check_mul_inplace, 2},
+    {"mullo", check_mullo, 2},
+    {"mulhi", check_mulhi, 2},
+    {"prod_uwords", check_prod_uwords, 1},
+    {"factorial", check_factorial, 1},
+    {"binomial", check_binomial, 1},
+    {"divmod_uword", check_divmod_uword, 1},
+    {"mod_uword_multi", check_mod_uword_multi, 1},
+    {"crt", check_crt, 1},
+    {"divmod_unsafe", check_divmod_unsafe, 4},
+    {"divmod_short", check_divmod_short, 2},
+    {"div", check_div, 2},
+    {"mod", check_mod, 2},
+    {"divrem", check_divrem, 2},
+    {"div_appr", check_div_appr, 2},
+    {"quotient", check_quotient, 2},
+    {"divexact_uword", check_divexact_uword, 1},
+    {"divexact", check_divexact, 2},
+    {"tobits_round", check_tobits_round, 1},
+    {"tolong", check_tolong, 1},
+    {"long_tobits_round", check_long_tobits_round, 1},
+    {"frombits_round", check_frombits_round, 1},
+    {"mul_pow2", check_mul_pow2, 1},
+    {"divmod_pow2", check_divmod_pow2, 1},
+    {"shl10", check_shl10, 1},
+    {"shr10", check_shr10_trunc, 1},
+    {"shr10_round", check_shr10_round, 2},
+    {"pow", check_pow, 1},
+    {"pow2", check_pow2, 1},
+    {"sqrtrem", check_sqrtrem, 2},
+    {"gcd", check_gcd, 1},
+    {"gcdext", check_gcdext, 1},
+    {"pack", check_pack, 1},
+    {"from_double", check_from_double, 1},
+    {"to_double", check_to_double, 2},
+    {"regroup", check_regroup, 1},
+    {"divmod_step", check_divmod_step, 2},
+    {"mul_step", check_mul_step, 1},
+    {"tobits_step", check_tobits_step, 1},
+    {"frombits_step", check_frombits_step, 1},
+    {"helpers", check_helpers, 1},
+};
+
+enum { NCHECKS = sizeof(checks) / sizeof(checks[0]) };
+
+static void run_check(const Check *c)
+{
+    cur_op = c->name;
+    nnotes = 0;
+    c->check();
+}
+
+#if DECI_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (!size)
+        return 0;
+    src_data = data + 1;
+    src_size = size - 1;
+    run_check(&checks[data[0] % NCHECKS]);
+    return 0;
+}
+
+#else
+
+// --- timings ------------------------------------------------------------------------------
+//
+// Fixed workloads, one per kernel. Destructive ones restore their input before each call; the
+// restoring is included in the timing, which is fine as only the ratio to the baseline matters.
+
+enum { PERF_LINEAR_N = 4096, PERF_QUADRATIC_N = 128 };
+
+static deci_UWORD perf_a[2 * PERF_LINEAR_N], perf_a0[2 * PERF_LINEAR_N];
+static deci_UWORD perf_b[PERF_LINEAR_N];
+static deci_UWORD perf_out[2 * PERF_LINEAR_N];
+
+static void perf_reset(size_t n)
+{
+    deci_memcpy(perf_a, perf_a0, n);
+}
+
+static void perf_add(void)
+{
+    (void) deci_add(perf_a, perf_a + PERF_LINEAR_N, perf_b, perf_b + PERF_LINEAR_N);
+}
+
+static void perf_sub_raw(void)
+{
+    (void) deci_sub_raw(perf_a, perf_a + PERF_LINEAR_N, perf_b, perf_b + PERF_LINEAR_N);
+}
+
+static void perf_mul_uword(void)
+{
+    perf_reset(PERF_LINEAR_N);
+    (void) deci_mul_uword(perf_a, perf_a + PERF_LINEAR_N, DECI_BASE - 7);
+}
+
+static void perf_add_scaled(void)
+{
+    perf_out[PERF_LINEAR_N] = 0;
+    perf_out[PERF_LINEAR_N + 1] = 0;
+    deci_add_scaled(perf_out, DECI_BASE - 7, perf_b, perf_b + PERF_LINEAR_N);
+}
+
+static void perf_sub_scaled_raw(void)
+{
+    (void) deci_sub_scaled_raw(
+        perf_a, perf_a + PERF_LINEAR_N, DECI_BASE - 7, perf_b, perf_b + PERF_LINEAR_N);
+}
+
+static void perf_divmod_uword(void)
+{
+    perf_reset(PERF_LINEAR_N);
+    (void) deci_divmod_uword(perf_a, perf_a + PERF_LINEAR_N, DECI_BASE - 7);
+}
+
+static void perf_tobits_round(void)
+{
+    perf_reset(PERF_LINEAR_N);
+    (void) deci_tobits_round(perf_a, perf_a + PERF_LINEAR_N);
+}
+
+static void perf_frombits_round(void)
+{
+    perf_reset(PERF_LINEAR_N);
+    (void) deci_frombits_round(perf_a, perf_a + PERF_LINEAR_N);
+}
+
+static void perf_shr10(void)
+{
+    perf_reset(PERF_LINEAR_N);
+    (void) deci_shr10(perf_a, perf_a + PERF_LINEAR_N, DECI_BASE_LOG + 1, NULL);
+}
+
+static void perf_mul(void)
+{
+    deci_zero_out_n(perf_out, 2 * PERF_QUADRATIC_N);
+    deci_mul(perf_a0, perf_a0 + PERF_QUADRATIC_N, perf_b, perf_b + PERF_QUADRATIC_N, perf_out);
+}
+
+static void perf_divmod_unsafe(void)
+{
+    perf_reset(2 * PERF_QUADRATIC_N);
+    (void) deci_divmod_unsafe(
+        perf_a, perf_a + 2 * PERF_QUADRATIC_N, perf_b, perf_b + PERF_QUADRATIC_N);
+}
+
+static void perf_sqrtrem(void)
+{
+    perf_reset(2 * PERF_QUADRATIC_N);
+    (void) deci_sqrtrem(perf_a, perf_a + 2 * PERF_QUADRATIC_N, perf_out);
+}
+
+static void perf_gcd(void)
+{
+    perf_reset(PERF_QUADRATIC_N);
+    deci_memcpy(perf_out, perf_b, PERF_QUADRATIC_N);
+    (void) deci_gcd(
+        perf_a, perf_a + PERF_QUADRATIC_N, perf_out, perf_out + PERF_QUADRATIC_N,
+        perf_out + PERF_QUADRATIC_N);
+}
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} Perf;
+
+static const Perf perfs[] = {
+    {"add", perf_add},
+    {"sub_raw", perf_sub_raw},
+    {"mul_uword", perf_mul_uword},
+    {"add_scaled", perf_add_scaled},
+    {"sub_scaled_raw", perf_sub_scaled_raw},
+    {"divmod_uword", perf_divmod_uword},
+    {"tobits_round", perf_tobits_round},
+    {"frombits_round", perf_frombits_round},
+    {"shr10", perf_shr10},
+    {"mul", perf_mul},
+    {"divmod_unsafe", perf_divmod_unsafe},
+    {"sqrtrem", perf_sqrtrem},
+    {"gcd", perf_gcd},
+};
+
+enum { NPERFS = sizeof(perfs) / sizeof(perfs[0]) };
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Returns the time of one call in nanoseconds: the minimum over several rounds of at least 20 ms.
+static double perf_measure(const Perf *p)
+{
+    enum { ROUNDS = 7 };
+    const double min_round_ns = 20e6;
+
+    double best = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        size_t iters = 0;
+        const double start = now_ns();
+        double elapsed;
+        do {
+            p->run();
+            ++iters;
+        } while ((elapsed = now_ns() - start) < min_round_ns);
+        const double ns = elapsed / iters;
+        if (!round || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+static void perf_init(void)
+{
+    rng_state = 88172645463325252ull;
+    for (size_t i = 0; i < 2 * PERF_LINEAR_N; ++i)
+        perf_a0[i] = rand_u64() % DECI_BASE;
+    for (size_t i = 0; i < PERF_LINEAR_N; ++i)
+        perf_b[i] = rand_u64() % DECI_BASE;
+    perf_b[PERF_QUADRATIC_N - 1] |= 1;
+    deci_memcpy(perf_a, perf_a0, 2 * PERF_LINEAR_N);
+}
+
+static int perf_save(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    fprintf(f, "# libdeci kernel timings, ns per call; word_bits %d\n", DECI_WORD_BITS);
+    for (size_t i = 0; i < NPERFS; ++i) {
+        const double ns = perf_measure(&perfs[i]);
+        fprintf(f, "%s %.1f\n", perfs[i].name, ns);
+        fprintf(stderr, "%-16s %12.1f ns\n", perfs[i].name, ns);
+    }
+    if (fclose(f) != 0) {
+        perror(path);
+        return 1;
+    }
+    return 0;
+}
+
+static int perf_check(const char *path, double tolerance_percent)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    int word_bits;
+    if (fscanf(f, "# libdeci kernel timings, ns per call; word_bits %d", &word_bits) != 1) {
+        fprintf(stderr, "%s: bad header.\n", path);
+        fclose(f);
+        return 1;
+    }
+    if (word_bits != DECI_WORD_BITS) {
+        fprintf(stderr, "%s: baseline is for word_bits %d, this build has %d.\n",
+                path, word_bits, DECI_WORD_BITS);
+        fclose(f);
+        return 1;
+    }
+
+    int ret = 0;
+    char name[64];
+    double base_ns;
+    while (fscanf(f, "%63s %lf", name, &base_ns) == 2) {
+        const Perf *p = NULL;
+        for (size_t i = 0; i < NPERFS; ++i)
+            if (strcmp(perfs[i].name, name) == 0)
+                p = &perfs[i];
+        if (!p) {
+            fprintf(stderr, "%s: unknown kernel '%s', ignoring.\n", path, name);
+            continue;
+        }
+        const double ns = perf_measure(p);
+        const bool slower = ns > base_ns * (1 + tolerance_percent / 100);
+        fprintf(stderr, "%-16s %12.1f ns (baseline %12.1f ns, %+6.1f%%)%s\n",
+                name, ns, base_ns, (ns / base_ns - 1) * 100, slower ? "  SLOWER" : "");
+        if (slower)
+            ret = 1;
+    }
+    fclose(f);
+
+    if (ret)
+        fprintf(stderr, "Some kernels got more than %g%% slower than the baseline.\n",
+                tolerance_percent);
+    return ret;
+}
+
+#if DECI_STATS
+static void print_histogram(const char *name, const uint64_t *h)
+{
+    fprintf(stderr, "  %s:", name);
+    for (int i = 0; i < DECI_STATS_NBUCKETS; ++i)
+        if (h[i])
+            fprintf(stderr, " [%d]=%llu", i, (unsigned long long) h[i]);
+    fputc('\n', stderr);
+}
+
+static void print_stats(void)
+{
+    deci_Stats st;
+    deci_stats_snapshot(&st);
+    fputs("Statistics (histogram bucket i > 0 counts values in [2^(i-1), 2^i)):\n", stderr);
+    for (int i = 0; i < DECI_STATS_NENTRIES; ++i)
+        if (st.calls[i])
+            fprintf(stderr, "  %-18s %12llu calls %14llu words\n",
+                    deci_stats_entry_name((deci_StatsEntry) i),
+                    (unsigned long long) st.calls[i], (unsigned long long) st.words[i]);
+    fprintf(stderr, "  long division: %llu rounds, %llu corrections\n",
+            (unsigned long long) st.div_rounds, (unsigned long long) st.div_corrections);
+    print_histogram("add carry tails", st.add_carry_tails);
+    print_histogram("sub borrow tails", st.sub_borrow_tails);
+    print_histogram("mul sizes", st.sizes[DECI_STATS_MUL]);
+}
+#endif
+
+static void usage(void)
+{
+    fputs("USAGE: fuzz [-n ITERATIONS] [-s SEED] [-S BASELINE_FILE] [-C BASELINE_FILE]"
+          " [-T TOLERANCE_PERCENT]\n", stderr);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t iterations = 1000000;
+    uint64_t seed = (uint64_t) time(NULL);
+    const char *save_path = NULL;
+    const char *check_path = NULL;
+    double tolerance_percent = 25;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc || argv[i][0] != '-' || !argv[i][1] || argv[i][2])
+            usage();
+        const char *arg = argv[++i];
+        switch (argv[i - 1][1]) {
+        case 'n':
+            iterations = strtoull(arg, NULL, 10);
+            break;
+        case 's':
+            seed = strtoull(arg, NULL, 10);
+            break;
+        case 'S':
+            save_path = arg;
+            break;
+        case 'C':
+            check_path = arg;
+            break;
+        case 'T':
+            tolerance_percent = atof(arg);
+            break;
+        default:
+            usage();
+        }
+    }
+
+    int total_weight = 0;
+    for (size_t i = 0; i < NCHECKS; ++i)
+        total_weight += checks[i].weight;
+
+    cur_seed = seed;
+    // xorshift must not start from zero.
+    rng_state = seed * 0x9E3779B97F4A7C15ull + 1;
+    if (!rng_state)
+        rng_state = 1;
+
+    for (cur_iter = 0; cur_iter < iterations; ++cur_iter) {
+        int x = rand_below(total_weight);
+        size_t i = 0;
+        while (x >= checks[i].weight)
+            x -= checks[i++].weight;
+        run_check(&checks[i]);
+    }
+    fprintf(stderr, "fuzz: %llu iterations with seed %llu (word_bits %d) passed.\n",
+            (unsigned long long) iterations, (unsigned long long) seed, DECI_WORD_BITS);
+
+#if DECI_STATS
+    print_stats();
+#endif
+
+    int ret = 0;
+    if (save_path || check_path)
+        perf_init();
+    if (save_path)
+        ret |= perf_save(save_path);
+    if (check_path)
+        ret |= perf_check(check_path, tolerance_percent);
+    return ret;
+}
+
+#endif
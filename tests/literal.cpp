@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020  libdeci developers
+ *
+ * This file is part of libdeci.
+ *
+ * libdeci is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libdeci is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libdeci.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Tests of 'deci.hpp'. The layout of the constants is checked with 'static_assert's, so most of
+// this test is done by compiling it; 'main()' then passes some of them to the span API.
+
+#include <stdio.h>
+#include "../deci.hpp"
+
+using namespace deci::literals;
+
+// Returns true if 'c' holds exactly the 'M' words of 'expected'.
+template <size_t N, size_t M>
+constexpr bool words_equal(const deci::Constant<N> &c, const deci_UWORD (&expected)[M])
+{
+    if (N != M)
+        return false;
+    for (size_t i = 0; i < N; ++i)
+        if (c.words[i] != expected[i])
+            return false;
+    return true;
+}
+
+// Returns true if 'c' holds the words of 'x', converted by repeated division.
+template <size_t N>
+constexpr bool value_equal(const deci::Constant<N> &c, uint64_t x)
+{
+    size_t i = 0;
+    for (; x; x /= DECI_BASE, ++i)
+        if (i == N || c.words[i] != x % DECI_BASE)
+            return false;
+    return i == N;
+}
+
+static_assert(decltype(0_deci)::size() == 0, "");
+static_assert(value_equal(1_deci, 1), "");
+static_assert(value_equal(9999_deci, 9999), "");
+static_assert(value_equal(10000_deci, 10000), "");
+static_assert(value_equal(999999999_deci, 999999999), "");
+static_assert(value_equal(1000000000_deci, 1000000000), "");
+static_assert(value_equal(1'000'000'000'000'000'000_deci, 1000000000000000000u), "");
+static_assert(value_equal(18446744073709551615_deci, 18446744073709551615u), "");
+
+#if DECI_WE_ARE_64_BIT
+static constexpr deci_UWORD M127[] = {884105727, 687303715, 469231731, 141183460, 170};
+#else
+static constexpr deci_UWORD M127[] = {5727, 8410, 7158, 7303, 3168, 2317, 469, 8346, 1411, 170};
+#endif
+static_assert(words_equal(170141183460469231731687303715884105727_deci, M127), "");
+
+static constexpr auto P = 123456789012345678901234567890_deci;
+static constexpr auto Q = 987654321098765432109876543210_deci;
+static constexpr auto PQ =
+    121932631137021795226185032733622923332237463801111263526900_deci;
+
+int main()
+{
+    // The constants are read-only operands here; the result goes into a separate buffer.
+    deci_UWORD out[P.size() + Q.size()] = {0};
+    deci_mul(P.begin(), P.end(), Q.begin(), Q.end(), out);
+
+    const size_t n = deci_normalize_n(out, P.size() + Q.size());
+    if (n != PQ.size() || deci_compare_n(out, PQ.begin(), n, -1, 0, 1) != 0) {
+        fprintf(stderr, "literal: P * Q != PQ\n");
+        return 1;
+    }
+
+    // A non-const copy may be modified.
+    auto a = 1000000000000000000_deci;
+    static constexpr auto ONE = 1_deci;
+    static constexpr auto NINES = 999999999999999999_deci;
+    const bool borrow = deci_sub_raw(a.begin(), a.end(), ONE.begin(), ONE.end());
+    const size_t na = deci_normalize_n(a.begin(), a.size());
+    if (borrow || na != NINES.size() || deci_compare_n(a.begin(), NINES.begin(), na, -1, 0, 1) != 0) {
+        fprintf(stderr, "literal: 10^18 - 1 != NINES\n");
+        return 1;
+    }
+
+    return 0;
+}